@@ -0,0 +1,97 @@
+// скорость поколения на случайном поле двух игроков: клеточный расчёт
+// GameModel против BitboardGameEngine: bitboard_bench [размер поля] [поколений]
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+#include "game_model.hpp"
+#include "bitboard_engine.hpp"
+
+namespace {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_model;
+
+    std::shared_ptr<GameFieldWithFigure> makeField(
+        int size, const std::vector<std::shared_ptr<player::Player>>& players)
+    {
+        auto field = std::make_shared<GameFieldWithFigure>(
+            size, size,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<int> dist(0, 5);
+        std::vector<change_t> soup;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                int v = dist(gen);
+                if (v < static_cast<int>(players.size())) {
+                    soup.emplace_back(x, y, field->registerPlayer(players[v]));
+                }
+            }
+        }
+        field->applyChanges(soup);
+        return field;
+    }
+
+    std::unique_ptr<GameModel> makeModel(
+        std::shared_ptr<GameFieldWithFigure> field,
+        const std::vector<std::shared_ptr<player::Player>>& players,
+        std::unique_ptr<game_engine::IGameEngine> engine)
+    {
+        std::pair<int, int> lu {0, 0};
+        std::pair<int, int> rl {field->width() - 1, field->height() - 1};
+        auto area = std::make_unique<GameFieldWithFigureArea>(field, lu, rl);
+        area->unlock();
+        auto f = std::make_unique<GameFieldWithFigureAreaCurryFactory>(field);
+        return std::make_unique<GameModel>(
+            0, 0, 0, std::move(area), std::move(f), players,
+            std::make_unique<creature_strategy::ConwayCreatureStrategy>(),
+            std::move(engine));
+    }
+
+    // поколений в секунду
+    double measure(GameModel& model, int generations) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < generations; ++i) {
+            model.computeEr_();
+        }
+        std::chrono::duration<double> time =
+            std::chrono::steady_clock::now() - start;
+        return generations / time.count();
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int size = argc > 1 ? std::stoi(argv[1]) : 1024;
+    int generations = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    std::vector<std::shared_ptr<player::Player>> players {
+        std::make_shared<player::Player>(0, "player1"),
+        std::make_shared<player::Player>(1, "player2"),
+    };
+
+    std::cout << "field " << size << 'x' << size << '\n';
+    std::cout << std::fixed << std::setprecision(2);
+
+    // оба расчёта идут с одного поля одинаковое количество поколений:
+    // первые поколения случайного поля меняют больше клеток
+    auto cellwiseField = makeField(size, players);
+    auto cellwise = makeModel(cellwiseField, players, nullptr);
+    double cellwiseRate = measure(*cellwise, generations);
+    std::cout << "cellwise: " << cellwiseRate << " gens/s ("
+              << generations << " generations)\n";
+
+    auto bitboardField = makeField(size, players);
+    auto bitboard = makeModel(bitboardField, players,
+        std::make_unique<game_engine::BitboardGameEngine>(bitboardField));
+    double bitboardRate = measure(*bitboard, generations);
+    std::cout << "bitboard: " << bitboardRate << " gens/s ("
+              << generations << " generations), "
+              << bitboardRate / cellwiseRate << "x cellwise\n";
+}
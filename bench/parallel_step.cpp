@@ -0,0 +1,92 @@
+// масштабирование параллельного шага GameModel по количеству потоков
+// на поле-ромбе: bench [размер поля] [поколений]
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+#include "game_model.hpp"
+
+namespace {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_model;
+
+    std::shared_ptr<GameFieldWithFigure> makeField(
+        int size, const std::vector<std::shared_ptr<player::Player>>& players)
+    {
+        auto field = std::make_shared<GameFieldWithFigure>(
+            size, size,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::Romb>(size / 2, size / 2));
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<int> dist(0, 5);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                int v = dist(gen);
+                if (v < static_cast<int>(players.size()) 
+                    && !field->isExcludedCell(x, y)) 
+                {
+                    field->setCreatureInCell(x, y, players[v]);
+                }
+            }
+        }
+        return field;
+    }
+
+    std::unique_ptr<GameModel> makeModel(
+        std::shared_ptr<GameFieldWithFigure> field,
+        const std::vector<std::shared_ptr<player::Player>>& players,
+        int threads)
+    {
+        std::pair<int, int> lu {0, 0};
+        std::pair<int, int> rl {field->width() - 1, field->height() - 1};
+        auto area = std::make_unique<GameFieldWithFigureArea>(field, lu, rl);
+        area->unlock();
+        auto f = std::make_unique<GameFieldWithFigureAreaCurryFactory>(field);
+        return std::make_unique<GameModel>(
+            0, 0, 0, std::move(area), std::move(f), players,
+            std::make_unique<creature_strategy::ConwayCreatureStrategy>(),
+            nullptr,
+            std::make_unique<thread_pool::ThreadPool>(threads));
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int size = argc > 1 ? std::stoi(argv[1]) : 4096;
+    int generations = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    std::vector<std::shared_ptr<player::Player>> players {
+        std::make_shared<player::Player>(0, "player1"),
+        std::make_shared<player::Player>(1, "player2"),
+    };
+
+    std::cout << "field " << size << 'x' << size << ", " 
+              << generations << " generations\n";
+    double base = 0;
+    for (int threads : { 1, 2, 4, 8, 16 }) {
+        auto field = makeField(size, players);
+        auto model = makeModel(field, players, threads);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < generations; ++i) {
+            model->computeEr_();
+        }
+        std::chrono::duration<double> time = 
+            std::chrono::steady_clock::now() - start;
+        double perGen = time.count() / generations;
+        if (threads == 1) base = perGen;
+        std::cout << std::setw(2) << threads << " threads: " 
+                  << std::fixed << std::setprecision(3) 
+                  << perGen << " s/gen, speedup " 
+                  << std::setprecision(2) << base / perGen;
+        auto stats = model->threadPool()->stats();
+        std::chrono::duration<double> idle = stats.idle;
+        std::cout << ", steals " << stats.steals 
+                  << ", idle " << std::setprecision(3) 
+                  << idle.count() / threads / generations << " s/gen\n";
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef ACTIVE_TILES_HPP
+#define ACTIVE_TILES_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "topology.hpp"
+
+namespace active_tiles {
+
+// поле, разбитое на квадратные плитки: плитка пересчитывается, только
+// если она или соседняя плитка изменилась в прошлом поколении
+class ActiveTiles {
+public:
+    static constexpr int tileSize = 16;
+
+public:
+    ActiveTiles() = default;
+    ActiveTiles(int width, int height, topology::topology_t topology);
+
+public:
+    void markChanged(int xidx, int yidx) noexcept;
+    void markAllChanged() noexcept;
+    // плитка клетки активна в каждом поколении
+    void pin(int xidx, int yidx) noexcept;
+    // активировать изменившиеся плитки с соседями и сбросить изменения
+    void activate();
+    bool isActive(int tileX, int tileY) const noexcept;
+    int activeCount() const noexcept;
+    int tilesX() const noexcept;
+    int tilesY() const noexcept;
+
+private:
+    std::size_t index_(int tileX, int tileY) const noexcept;
+    static bool test_(const std::vector<std::uint64_t>& bits, 
+                      std::size_t idx) noexcept;
+    static void set_(std::vector<std::uint64_t>& bits, 
+                     std::size_t idx) noexcept;
+
+private:
+    int tilesX_ = 0;
+    int tilesY_ = 0;
+    topology::topology_t topology_ = topology::topology_t::BOUNDED;
+    std::vector<std::uint64_t> changed_;
+    std::vector<std::uint64_t> active_;
+    std::vector<std::uint64_t> pinned_;
+};
+
+} // namespace active_tiles
+
+#endif // ACTIVE_TILES_HPP
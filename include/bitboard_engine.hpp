@@ -0,0 +1,53 @@
+#ifndef BITBOARD_ENGINE_HPP
+#define BITBOARD_ENGINE_HPP
+
+#include <cstdint>
+#include <array>
+#include <vector>
+
+#include "grid_engine.hpp"
+
+namespace game_engine {
+
+// поле хранится битовыми плоскостями: одна плоскость на игрока,
+// по 64 клетки в слове; поколение считается пословно. у плоскостей
+// есть рамка из слов и строк, заполняемая по топологии поля.
+// плоскости живут между поколениями и обновляются по изменениям
+// движка; заново из поля они собираются, только если поле
+// менялось не через движок
+class BitboardGameEngine : public GridGameEngine {
+    using word_t = std::uint64_t;
+    // счётчик соседей, разложенный по битам: sum[i] - i-й бит числа
+    using counter_t = std::array<word_t, 4>;
+
+public:
+    BitboardGameEngine(std::shared_ptr<GameFieldWithFigure> field);
+
+private:
+    void computeChanges_(const FlatCellStorage& storage) override;
+    void changesApplied_(const FlatCellStorage& storage) override;
+    void loadPlanes_(const FlatCellStorage& storage);
+    void addOwnerPlane_(owner_t own);
+    void fillGhostBorder_(std::vector<word_t>& plane) const;
+    std::size_t wordIndex_(int yidx, int widx) const noexcept;
+    counter_t countNeighbors_(
+        const std::vector<word_t>& plane, int yidx, int widx) const;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int wordsPerRow_ = 0;
+    int stride_ = 0;
+    word_t lastWordMask_ = 0;
+    // planes_[0] - все существа, planes_[owner] - существа владельца
+    std::array<std::vector<word_t>, cell_storage::maxPlayers + 1> planes_;
+    std::vector<owner_t> presentOwners_;
+    std::array<bool, cell_storage::maxPlayers + 1> hasPlane_{};
+    // состояние поля, по которому собраны плоскости
+    bool planesLoaded_ = false;
+    std::uint64_t planesVersion_ = 0;
+};
+
+} // namespace game_engine
+
+#endif // BITBOARD_ENGINE_HPP
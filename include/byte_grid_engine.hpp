@@ -0,0 +1,38 @@
+#ifndef BYTE_GRID_ENGINE_HPP
+#define BYTE_GRID_ENGINE_HPP
+
+#include <cstdint>
+#include <array>
+#include <vector>
+
+#include "grid_engine.hpp"
+
+namespace game_engine {
+
+// поле хранится байтовыми сетками с рамкой в одну клетку по топологии поля,
+// суммы соседей считаются для целой строки векторным ядром
+class ByteGridGameEngine : public GridGameEngine {
+public:
+    ByteGridGameEngine(std::shared_ptr<GameFieldWithFigure> field);
+
+private:
+    void computeChanges_(const FlatCellStorage& storage) override;
+    void loadGrid_(const FlatCellStorage& storage);
+    void sumRow_(const std::vector<std::uint8_t>& plane, 
+                 int yidx, std::vector<std::uint8_t>& out) const;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int stride_ = 0;
+    // владельцы клеток с рамкой: на торе рамка - копия противоположного края
+    std::vector<owner_t> grid_;
+    // planes_[0] - все существа, planes_[owner] - существа владельца
+    std::array<std::vector<std::uint8_t>, cell_storage::maxPlayers + 1> planes_;
+    std::array<std::vector<std::uint8_t>, cell_storage::maxPlayers + 1> sums_;
+    std::vector<owner_t> presentOwners_;
+};
+
+} // namespace game_engine
+
+#endif // BYTE_GRID_ENGINE_HPP
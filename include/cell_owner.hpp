@@ -0,0 +1,28 @@
+#ifndef CELL_OWNER_HPP
+#define CELL_OWNER_HPP
+
+#include <cstdint>
+#include <array>
+#include <tuple>
+
+namespace cell_storage {
+
+// владелец клетки: 0 - клетка пуста, иначе id игрока + 1
+using owner_t = std::uint8_t;
+
+constexpr owner_t emptyOwner = 0;
+constexpr int maxPlayers = 16;
+
+// количество соседей каждого игрока, индекс - id игрока
+using neighbor_counts_t = std::array<int, maxPlayers>;
+
+// количество существ каждого владельца, индекс - owner_t;
+// пустые клетки не считаются: элемент emptyOwner всегда 0
+using population_t = std::array<int, maxPlayers + 1>;
+
+// изменение клетки: x, y, новый владелец
+using change_t = std::tuple<int, int, owner_t>;
+
+} // namespace cell_storage
+
+#endif // CELL_OWNER_HPP
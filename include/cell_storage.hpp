@@ -0,0 +1,183 @@
+#ifndef CELL_STORAGE_HPP
+#define CELL_STORAGE_HPP
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "cell_owner.hpp"
+#include "cell_factory.hpp"
+#include "neighbor_table.hpp"
+
+namespace cell_storage {
+
+// клетка строки, изменившаяся при обмене буферов:
+// x, прежний владелец, новый владелец
+using row_change_t = std::tuple<int, owner_t, owner_t>;
+
+struct ICellStorage {
+    virtual void reset(int width, int height) = 0;
+    virtual owner_t owner(int xidx, int yidx) const = 0;
+    virtual void setOwner(int xidx, int yidx, owner_t owner) = 0;
+    virtual bool hasCreature(int xidx, int yidx) const = 0;
+    virtual void removeCreature(int xidx, int yidx) = 0;
+    virtual void setNeighborTable(
+        std::shared_ptr<const neighbor_table::NeighborTable> table) = 0;
+    // заполняет count без выделения памяти
+    virtual void countNeighborsCreatures(
+        int xidx, int yidx, neighbor_counts_t& count) const = 0;
+    virtual int width() const noexcept = 0;
+    virtual int height() const noexcept = 0;
+
+    // второй буфер: следующее поколение начинается с копии текущего,
+    // пишется без проверок и становится текущим обменом буферов.
+    // копия - O(клеток) за поколение: так клетки вне активных плиток
+    // переходят в следующее поколение без записи
+    virtual void beginGeneration() = 0;
+    virtual void setNextOwner(int xidx, int yidx, owner_t owner) noexcept = 0;
+    virtual void swapGeneration() noexcept = 0;
+    // владелец клетки до последнего обмена буферов
+    virtual owner_t previousOwner(int xidx, int yidx) const = 0;
+    // дописать в diff клетки строки yidx из [xbegin, xend), изменившиеся
+    // при последнем обмене буферов; буферы сравниваются напрямую,
+    // отрезок не проверяется
+    virtual void diffGeneration(int yidx, int xbegin, int xend,
+        std::vector<row_change_t>& diff) const = 0;
+    // владельцы и количества соседей подряд идущих клеток строки yidx,
+    // начиная с xbegin, по клетке на элемент owners: один вызов на
+    // отрезок, клетки читаются из буфера без проверок
+    virtual void readSpan(int yidx, int xbegin, std::span<owner_t> owners,
+        std::span<neighbor_counts_t> counts) const = 0;
+
+    virtual ~ICellStorage() = default;
+};
+
+// клетки - отдельные объекты, создаваемые фабрикой;
+// при сбросе к тем же размерам объекты переиспользуются
+class CellObjectStorage : public ICellStorage {
+public:
+    CellObjectStorage(std::unique_ptr<factory::ICellFactory> cellFactory);
+
+public:
+    void reset(int width, int height) override;
+    owner_t owner(int xidx, int yidx) const override;
+    void setOwner(int xidx, int yidx, owner_t owner) override;
+    bool hasCreature(int xidx, int yidx) const override;
+    void removeCreature(int xidx, int yidx) override;
+    void setNeighborTable(
+        std::shared_ptr<const neighbor_table::NeighborTable> table) override;
+    void countNeighborsCreatures(
+        int xidx, int yidx, neighbor_counts_t& count) const override;
+    int width() const noexcept override;
+    int height() const noexcept override;
+    void beginGeneration() override;
+    void setNextOwner(int xidx, int yidx, owner_t owner) noexcept override;
+    void swapGeneration() noexcept override;
+    owner_t previousOwner(int xidx, int yidx) const override;
+    void diffGeneration(int yidx, int xbegin, int xend,
+        std::vector<row_change_t>& diff) const override;
+    void readSpan(int yidx, int xbegin, std::span<owner_t> owners,
+        std::span<neighbor_counts_t> counts) const override;
+
+private:
+    void verifyThenThrowCellPos_(int xidx, int yidx) const;
+
+private:
+    std::vector<std::vector<std::unique_ptr<cell::ICell>>> field_;
+    std::unique_ptr<factory::ICellFactory> cellFactory_;
+    std::shared_ptr<const neighbor_table::NeighborTable> neighbors_;
+    // второй буфер построчно, клетки-объекты обмениваются с ним 
+    // владельцами: обмен - проход по всем клеткам, а не обмен векторов
+    std::vector<owner_t> next_;
+};
+
+// состояние клеток хранится построчно в одном буфере, один байт на клетку
+class FlatCellStorage : public ICellStorage {
+public:
+    void reset(int width, int height) override;
+    owner_t owner(int xidx, int yidx) const override;
+    void setOwner(int xidx, int yidx, owner_t owner) override;
+    bool hasCreature(int xidx, int yidx) const override;
+    void removeCreature(int xidx, int yidx) override;
+    void setNeighborTable(
+        std::shared_ptr<const neighbor_table::NeighborTable> table) override;
+    void countNeighborsCreatures(
+        int xidx, int yidx, neighbor_counts_t& count) const override;
+    int width() const noexcept override;
+    int height() const noexcept override;
+    void beginGeneration() override;
+    void setNextOwner(int xidx, int yidx, owner_t owner) noexcept override;
+    void swapGeneration() noexcept override;
+    owner_t previousOwner(int xidx, int yidx) const override;
+    void diffGeneration(int yidx, int xbegin, int xend,
+        std::vector<row_change_t>& diff) const override;
+    void readSpan(int yidx, int xbegin, std::span<owner_t> owners,
+        std::span<neighbor_counts_t> counts) const override;
+
+public:
+    const std::vector<owner_t>& owners() const noexcept;
+
+private:
+    std::size_t index_(int xidx, int yidx) const;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<owner_t> cells_;
+    std::vector<owner_t> next_;
+    std::shared_ptr<const neighbor_table::NeighborTable> neighbors_;
+};
+
+// построчный буфер владельцев и счётчики соседей каждого игрока,
+// которые обновляются при изменении клеток: подсчёт соседей
+// не обходит окрестность, а копирует счётчики клетки
+class CountingCellStorage : public ICellStorage {
+public:
+    void reset(int width, int height) override;
+    owner_t owner(int xidx, int yidx) const override;
+    void setOwner(int xidx, int yidx, owner_t owner) override;
+    bool hasCreature(int xidx, int yidx) const override;
+    void removeCreature(int xidx, int yidx) override;
+    void setNeighborTable(
+        std::shared_ptr<const neighbor_table::NeighborTable> table) override;
+    void countNeighborsCreatures(
+        int xidx, int yidx, neighbor_counts_t& count) const override;
+    int width() const noexcept override;
+    int height() const noexcept override;
+    void beginGeneration() override;
+    void setNextOwner(int xidx, int yidx, owner_t owner) noexcept override;
+    void swapGeneration() noexcept override;
+    owner_t previousOwner(int xidx, int yidx) const override;
+    void diffGeneration(int yidx, int xbegin, int xend,
+        std::vector<row_change_t>& diff) const override;
+    void readSpan(int yidx, int xbegin, std::span<owner_t> owners,
+        std::span<neighbor_counts_t> counts) const override;
+
+public:
+    const std::vector<owner_t>& owners() const noexcept;
+
+private:
+    std::size_t index_(int xidx, int yidx) const;
+    // перенести клетку из счётчиков from в счётчики to у зависящих от неё клеток
+    void moveOwner_(std::size_t cell, owner_t from, owner_t to) noexcept;
+    void recount_() noexcept;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<owner_t> cells_;
+    std::vector<owner_t> next_;
+    // maxPlayers счётчиков на клетку; соседей у клетки меньше 256
+    std::vector<std::uint8_t> counts_;
+    // клетки, записанные в следующее поколение, без повторов;
+    // память под все клетки выделяется при сбросе
+    std::vector<std::uint32_t> pending_;
+    std::vector<bool> isPending_;
+    std::shared_ptr<const neighbor_table::NeighborTable> neighbors_;
+    // клетки, соседом которых является клетка
+    std::shared_ptr<const neighbor_table::NeighborTable> dependents_;
+};
+
+} // namespace cell_storage
+
+#endif // CELL_STORAGE_HPP
@@ -0,0 +1,75 @@
+#ifndef CHANGE_SET_HPP
+#define CHANGE_SET_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "cell_owner.hpp"
+
+namespace change_set {
+
+// изменения поля одним сообщением: построчный индекс клетки и новый
+// владелец. после оповещения набор не меняется, поэтому его можно
+// сохранить и обработать позже, в том числе в другом потоке
+class ChangeSet {
+    using owner_t = cell_storage::owner_t;
+
+public:
+    ChangeSet(int width, std::uint64_t sequence);
+
+public:
+    void add(int xidx, int yidx, owner_t owner);
+    // начать набор заново без освобождения памяти
+    void reset(int width, std::uint64_t sequence) noexcept;
+
+public:
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    std::uint32_t cell(std::size_t i) const noexcept;
+    owner_t owner(std::size_t i) const noexcept;
+    std::pair<int, int> position(std::size_t i) const noexcept;
+    int width() const noexcept;
+    // наборы одного поля нумеруются подряд
+    std::uint64_t sequence() const noexcept;
+
+    // вызвать f(x, y, owner) для изменений в порядке добавления
+    template <class F>
+    void forEach(F&& f) const {
+        for (std::size_t i = 0; i < cells_.size(); ++i) {
+            f(static_cast<int>(cells_[i] % width_),
+              static_cast<int>(cells_[i] / width_), owners_[i]);
+        }
+    }
+
+private:
+    int width_;
+    std::uint64_t sequence_;
+    std::vector<std::uint32_t> cells_;
+    std::vector<owner_t> owners_;
+};
+
+// наборы для оповещений: набор, который освободил последний владелец,
+// возвращается в список свободных и выдаётся снова без выделения
+// памяти. освободить набор может любой поток: список защищён мьютексом,
+// поэтому следующий получатель видит все чтения прошлых владельцев.
+// список живёт, пока жив пул или хотя бы один выданный набор
+class ChangeSetPool {
+public:
+    std::shared_ptr<ChangeSet> acquire(int width, std::uint64_t sequence);
+
+private:
+    struct free_list_t {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ChangeSet>> sets;
+    };
+
+private:
+    std::shared_ptr<free_list_t> free_ = std::make_shared<free_list_t>();
+};
+
+} // namespace change_set
+
+#endif // CHANGE_SET_HPP
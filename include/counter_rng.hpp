@@ -0,0 +1,55 @@
+#ifndef COUNTER_RNG_HPP
+#define COUNTER_RNG_HPP
+
+#include <cstdint>
+
+namespace counter_rng {
+
+// генератор без состояния: число - хеш ключа (зерно, поколение, x, y),
+// поэтому результат не зависит от порядка обхода и количества потоков
+class CounterRng {
+public:
+    constexpr explicit CounterRng(std::uint64_t seed = 0) noexcept :
+        key_(seed)
+    {}
+
+public:
+    // генератор поколения: ключ дополняется номером поколения
+    constexpr CounterRng stream(std::uint64_t generation) const noexcept
+    { return CounterRng(mix_(key_ ^ mix_(generation + golden_))); }
+
+    constexpr std::uint64_t operator()(int xidx, int yidx) const noexcept {
+        std::uint64_t cell = 
+            static_cast<std::uint64_t>(static_cast<std::uint32_t>(xidx)) << 32
+            | static_cast<std::uint32_t>(yidx);
+        return mix_(key_ ^ mix_(cell));
+    }
+
+    // равномерно в [0, bound): умножение вместо деления по модулю
+    constexpr std::uint32_t uniform(
+        std::uint32_t bound, int xidx, int yidx) const noexcept
+    {
+        return static_cast<std::uint32_t>(
+            ((*this)(xidx, yidx) >> 32) * bound >> 32);
+    }
+
+    constexpr std::uint64_t key() const noexcept
+    { return key_; }
+
+private:
+    // финальное перемешивание splitmix64
+    static constexpr std::uint64_t mix_(std::uint64_t z) noexcept {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    static constexpr std::uint64_t golden_ = 0x9E3779B97F4A7C15ull;
+
+private:
+    std::uint64_t key_;
+};
+
+} // namespace counter_rng
+
+#endif // COUNTER_RNG_HPP
@@ -1,18 +1,141 @@
 #ifndef CREATURE_STRATEGY_HPP
 #define CREATURE_STRATEGY_HPP
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
 namespace creature_strategy {
 
+struct ICreatureStrategy;
+
+// решение стратегии для каждого состояния клетки и количества соседей:
+// бит n маски - решение при n соседях
+class TransitionTable {
+public:
+    using mask_t = std::uint32_t;
+    // соседи Мура и соседи связанной клетки
+    static constexpr int maxNeighbors = 16;
+
+public:
+    constexpr TransitionTable() = default;
+    constexpr TransitionTable(mask_t birth, mask_t survive) noexcept :
+        masks_{ birth, survive }
+    {}
+
+    // опросить стратегию один раз для всех состояний
+    static TransitionTable sample(ICreatureStrategy& strategy);
+
+public:
+    constexpr bool next(bool isAlive, int neighborsCount) const noexcept
+    { return (masks_[isAlive] >> neighborsCount) & 1; }
+    constexpr bool birth(int neighborsCount) const noexcept
+    { return next(false, neighborsCount); }
+    constexpr bool survive(int neighborsCount) const noexcept
+    { return next(true, neighborsCount); }
+    constexpr mask_t birthMask() const noexcept
+    { return masks_[0]; }
+    constexpr mask_t surviveMask() const noexcept
+    { return masks_[1]; }
+
+    constexpr bool operator==(const TransitionTable&) const = default;
+
+private:
+    // [0] - рождение в пустой клетке, [1] - выживание существа
+    std::array<mask_t, 2> masks_{};
+};
+
 struct ICreatureStrategy {
     virtual bool computeLiveStatus(int neighborsCount, bool isAlive) = 0; 
+    // по умолчанию таблица получается опросом computeLiveStatus
+    virtual TransitionTable transitionTable();
+
+    virtual ~ICreatureStrategy() = default;
 };
 
-class ConwayCreatureStrategy : public ICreatureStrategy {
+// стратегия, заданная готовой таблицей
+class TableCreatureStrategy : public ICreatureStrategy {
+public:
+    explicit TableCreatureStrategy(const TransitionTable& table);
+
 public:
     bool computeLiveStatus(int neighborsCount, bool isAlive) override;
+    TransitionTable transitionTable() override;
+
+private:
+    TransitionTable table_;
+};
+
+// правило в нотации B/S, например B36/S23: цифры после B - количества 
+// соседей для рождения, после S - для выживания. в константном 
+// выражении ошибка разбора - ошибка компиляции
+constexpr TransitionTable parseRule(std::string_view rule) {
+    std::array<TransitionTable::mask_t, 2> masks{};
+    std::array<bool, 2> seen{};
+    std::size_t pos = 0;
+    for (int part = 0; part < 2; ++part) {
+        if (part && (pos >= rule.size() || rule[pos++] != '/')) {
+            throw std::invalid_argument("Expected '/' in the rule.");
+        }
+        char c = pos < rule.size() ? rule[pos++] : '\0';
+        int section = (c == 'B' || c == 'b') ? 0 
+                    : (c == 'S' || c == 's') ? 1 : -1;
+        if (section < 0 || seen[section]) {
+            throw std::invalid_argument("Expected 'B' and 'S' in the rule.");
+        }
+        seen[section] = true;
+        for (; pos < rule.size() && rule[pos] != '/'; ++pos) {
+            if (rule[pos] < '0' || rule[pos] > '8') {
+                throw std::invalid_argument(
+                    "Neighbors count in the rule must be in 0..8.");
+            }
+            masks[section] |= TransitionTable::mask_t(1) << (rule[pos] - '0');
+        }
+    }
+    if (pos != rule.size()) {
+        throw std::invalid_argument("Unexpected tail of the rule.");
+    }
+    return { masks[0], masks[1] };
+}
+
+// строка правила как параметр шаблона
+template <std::size_t N>
+struct fixed_string {
+    constexpr fixed_string(const char (&str)[N]) {
+        for (std::size_t i = 0; i < N; ++i) data[i] = str[i];
+    }
+    constexpr std::string_view view() const noexcept
+    { return { data, N - 1 }; }
+
+    char data[N];
 };
 
+// правило разбирается при компиляции
+template <fixed_string Rule>
+class RuleCreatureStrategy : public TableCreatureStrategy {
+public:
+    static constexpr TransitionTable table = parseRule(Rule.view());
+
+public:
+    RuleCreatureStrategy() : TableCreatureStrategy(table) {}
+};
+
+// правило разбирается при создании, например из файла настроек
+class ParsedRuleCreatureStrategy : public TableCreatureStrategy {
+public:
+    explicit ParsedRuleCreatureStrategy(std::string_view rule);
+};
+
+using ConwayCreatureStrategy = RuleCreatureStrategy<"B3/S23">;
+using HighLifeCreatureStrategy = RuleCreatureStrategy<"B36/S23">;
+using DayAndNightCreatureStrategy = RuleCreatureStrategy<"B3678/S34678">;
+
+inline constexpr TransitionTable conwayTable = 
+    ConwayCreatureStrategy::table;
+
 } // namespace creature_strategy
 
 
-#endif // CREATURE_STRATEGY_HPP
\ No newline at end of file
+#endif // CREATURE_STRATEGY_HPP
@@ -0,0 +1,140 @@
+#ifndef EVENT_BUS_HPP
+#define EVENT_BUS_HPP
+
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+namespace event_bus {
+
+// обработчик принимает событие, если у него есть on(const Event&)
+template <class Handler, class Event>
+concept handles = requires (Handler& handler, const Event& evt) {
+    handler.on(evt);
+};
+
+// шина событий с набором типов, известным при компиляции.
+// событие - структура с данными, у каждого типа события свой плотный
+// список обработчиков. при подписке обработчик попадает только в списки
+// событий, для которых у него есть on(const Event&): привязка делается
+// при компиляции, без приведения номера события и switch.
+// событие без подписчиков стоит одной проверки пустого списка,
+// а hasSubscribers позволяет не собирать его данные
+template <class... Events>
+class EventBus {
+public:
+    // подписать обработчик на все события шины, которые он принимает
+    template <class Handler>
+    void subscribe(const std::shared_ptr<Handler>& handler) {
+        static_assert((handles<Handler, Events> || ...),
+            "The handler accepts no event of the bus.");
+        (subscribe_<Events>(handler), ...);
+    }
+
+    template <class Handler>
+    void unsubscribe(const std::shared_ptr<Handler>& handler) {
+        (unsubscribe_<Events>(handler.get()), ...);
+    }
+
+    template <class Event>
+    void publish(const Event& evt) const {
+        auto&& handlers = list_<Event>();
+        // обработчик может подписаться или отписаться во время оповещения:
+        // пока оно идёт, список только дополняется, отписанные помечаются
+        // умершими, а сжатие откладывается - обход по индексу не теряет
+        // обработчиков и переживает перевыделение памяти
+        dispatch_guard_t guard{ dispatchDepth_ };
+        for (std::size_t i = 0; i < handlers.size(); ++i) {
+            if (!handlers[i].ref.expired()) {
+                handlers[i].call(handlers[i].obj, evt);
+            }
+        }
+    }
+
+    template <class Event>
+    bool hasSubscribers() const noexcept {
+        return std::any_of(list_<Event>().begin(), list_<Event>().end(),
+            [] (auto&& ref) { return !ref.ref.expired(); });
+    }
+
+private:
+    template <class Event>
+    struct handler_ref_t {
+        void* obj;
+        void (*call)(void*, const Event&);
+        // только для проверки, что обработчик ещё жив
+        std::weak_ptr<const void> ref;
+    };
+
+    template <class Event>
+    using handlers_t = std::vector<handler_ref_t<Event>>;
+
+    // глубина вложенных оповещений на время publish
+    struct dispatch_guard_t {
+        explicit dispatch_guard_t(int& depth) noexcept : depth_(depth) 
+        { ++depth_; }
+        ~dispatch_guard_t() { --depth_; }
+
+        int& depth_;
+    };
+
+private:
+    template <class Event>
+    handlers_t<Event>& list_() noexcept {
+        static_assert((std::is_same_v<Event, Events> || ...),
+            "The event is not carried by the bus.");
+        return std::get<handlers_t<Event>>(handlers_);
+    }
+
+    template <class Event>
+    const handlers_t<Event>& list_() const noexcept {
+        static_assert((std::is_same_v<Event, Events> || ...),
+            "The event is not carried by the bus.");
+        return std::get<handlers_t<Event>>(handlers_);
+    }
+
+    template <class Event, class Handler>
+    void subscribe_(const std::shared_ptr<Handler>& handler) {
+        if constexpr (handles<Handler, Event>) {
+            auto&& handlers = list_<Event>();
+            compact_(handlers);
+            auto call = [] (void* obj, const Event& evt) {
+                static_cast<Handler*>(obj)->on(evt);
+            };
+            handlers.push_back({
+                const_cast<std::remove_const_t<Handler>*>(handler.get()),
+                call, handler });
+        }
+    }
+
+    template <class Event>
+    void unsubscribe_(const void* obj) {
+        auto&& handlers = list_<Event>();
+        auto el = std::find_if(handlers.begin(), handlers.end(),
+            [obj] (auto&& ref) { 
+                return ref.obj == obj && !ref.ref.expired(); 
+            });
+        if (el != handlers.end()) {
+            // во время оповещения запись только помечается умершей
+            el->ref.reset();
+            compact_(handlers);
+        }
+    }
+
+    // удалить умерших обработчиков при подписке и отписке вне оповещения
+    template <class Event>
+    void compact_(handlers_t<Event>& handlers) {
+        if (dispatchDepth_) return;
+        std::erase_if(handlers, [] (auto&& ref) { return ref.ref.expired(); });
+    }
+
+private:
+    std::tuple<handlers_t<Events>...> handlers_;
+    mutable int dispatchDepth_ = 0;
+};
+
+} // namespace event_bus
+
+#endif // EVENT_BUS_HPP
@@ -0,0 +1,75 @@
+#ifndef EVENT_QUEUE_HPP
+#define EVENT_QUEUE_HPP
+
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <variant>
+#include <vector>
+#include <type_traits>
+
+namespace event_bus {
+
+// очередь событий между потоками: подписывается на шину в потоке
+// источника как обычный обработчик, а события разбираются в потоке
+// получателя вызовом dispatch. события доходят все и по порядку
+template <class... Events>
+class EventQueue {
+public:
+    template <class Event>
+        requires (std::is_same_v<Event, Events> || ...)
+    void on(const Event& evt) {
+        {
+            std::lock_guard lk(mutex_);
+            queue_.emplace_back(evt);
+        }
+        ready_.notify_one();
+    }
+
+    // вызвать handler.on для накопленных событий, вернуть их количество
+    template <class Handler>
+    std::size_t dispatch(Handler& handler) {
+        {
+            std::lock_guard lk(mutex_);
+            taken_.swap(queue_);
+        }
+        return dispatchTaken_(handler);
+    }
+
+    // дождаться события не дольше timeout и разобрать накопленные
+    template <class Handler, class Rep, class Period>
+    std::size_t waitAndDispatch(Handler& handler,
+        std::chrono::duration<Rep, Period> timeout)
+    {
+        {
+            std::unique_lock lk(mutex_);
+            ready_.wait_for(lk, timeout, [this] { return !queue_.empty(); });
+            taken_.swap(queue_);
+        }
+        return dispatchTaken_(handler);
+    }
+
+private:
+    // обработчик вызывается без блокировки: он может положить
+    // в очередь новые события
+    template <class Handler>
+    std::size_t dispatchTaken_(Handler& handler) {
+        for (auto&& evt : taken_) {
+            std::visit([&handler] (auto&& e) { handler.on(e); }, evt);
+        }
+        auto n = taken_.size();
+        taken_.clear();
+        return n;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::vector<std::variant<Events...>> queue_;
+    // события, которые разбирает поток получателя
+    std::vector<std::variant<Events...>> taken_;
+};
+
+} // namespace event_bus
+
+#endif // EVENT_QUEUE_HPP
@@ -0,0 +1,88 @@
+#ifndef FIELD_SNAPSHOT_HPP
+#define FIELD_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cell_owner.hpp"
+#include "game_event.hpp"
+
+namespace game_field {
+    class GameFieldWithFigure;
+} // namespace game_field
+
+namespace change_set {
+    class ChangeSet;
+} // namespace change_set
+
+namespace field_snapshot {
+
+// клетка, изменившаяся с прошлого снимка: индекс построчно и владелец
+struct changed_cell_t {
+    std::uint32_t index;
+    cell_storage::owner_t owner;
+};
+
+// неизменяемые изменения поля с прошлого снимка: только клетки,
+// владелец которых мог измениться. снимок можно читать из любого потока
+class FieldSnapshot {
+public:
+    FieldSnapshot(int width, int height, std::uint64_t sequence,
+        std::vector<changed_cell_t> cells);
+
+public:
+    int width() const noexcept;
+    int height() const noexcept;
+    // снимки одного издателя нумеруются подряд
+    std::uint64_t sequence() const noexcept;
+    const std::vector<changed_cell_t>& changedCells() const noexcept;
+
+private:
+    int width_;
+    int height_;
+    std::uint64_t sequence_;
+    std::vector<changed_cell_t> cells_;
+};
+
+// издатель снимков: подписывается на события поля в потоке модели
+// и копит индексы изменившихся клеток без повторов. снимок собирается
+// только когда читатель забирает его, из клеток, накопленных
+// после прошлого снимка; первый снимок перечисляет все клетки
+class SnapshotPublisher {
+    using owner_t = cell_storage::owner_t;
+
+public:
+    explicit SnapshotPublisher(const game_field::GameFieldWithFigure& field);
+
+public:
+    void on(const game_event::FieldCleared&);
+    void on(const game_event::CreatureSet& evt);
+    void on(const game_event::CreatureRemoved& evt);
+    void on(const game_event::ChangesApplied& evt);
+
+public:
+    // изменения после прошлого снимка; nullptr - поле не менялось
+    std::shared_ptr<const FieldSnapshot> take();
+
+private:
+    void apply_(const change_set::ChangeSet& changes);
+    void markDirty_(std::size_t cell);
+
+private:
+    int width_;
+    int height_;
+    std::uint64_t sequence_ = 0;
+    // всё ниже пишет поток модели и читает take под блокировкой:
+    // поток модели держит её на время разбора одного события
+    std::mutex mutex_;
+    std::vector<owner_t> owners_;
+    // изменившиеся клетки; память под все клетки выделяется сразу
+    std::vector<std::uint32_t> dirty_;
+    std::vector<bool> isDirty_;
+};
+
+} // namespace field_snapshot
+
+#endif // FIELD_SNAPSHOT_HPP
@@ -0,0 +1,59 @@
+#ifndef FIGURE_MASK_HPP
+#define FIGURE_MASK_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "figure.hpp"
+
+namespace figure_mask {
+
+// отрезок строки [begin, end)
+struct span_t {
+    int begin;
+    int end;
+
+    bool operator==(const span_t&) const = default;
+};
+
+// фигура, растрированная один раз: бит на клетку 
+// и отрезки клеток фигуры для каждой строки
+class FigureMask {
+public:
+    FigureMask() = default;
+    FigureMask(int width, int height, figure::IFigure& figure);
+
+public:
+    // клетки вне поля не входят в фигуру
+    bool contains(int xidx, int yidx) const noexcept;
+    std::span<const span_t> rowSpans(int yidx) const noexcept;
+    // вызвать f(begin, end) для частей отрезков строки внутри [x0, x1)
+    template <class F>
+    void forEachSpan(int yidx, int x0, int x1, F&& f) const {
+        for (auto [begin, end] : rowSpans(yidx)) {
+            begin = std::max(begin, x0);
+            end = std::min(end, x1);
+            if (begin < end) f(begin, end);
+        }
+    }
+    // в фигуру входят все клетки поля
+    bool isFull() const noexcept;
+    int cellCount() const noexcept;
+    int width() const noexcept;
+    int height() const noexcept;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int cellCount_ = 0;
+    std::vector<std::uint64_t> bits_;
+    // отрезки строки yidx: spans_[rowOffsets_[yidx], rowOffsets_[yidx + 1])
+    std::vector<std::uint32_t> rowOffsets_;
+    std::vector<span_t> spans_;
+};
+
+} // namespace figure_mask
+
+#endif // FIGURE_MASK_HPP
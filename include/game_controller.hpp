@@ -2,22 +2,25 @@
 #define GAME_CONTROLLER_HPP
 
 #include <unordered_map>
+#include <atomic>
 
 #include "game_field_area_factory.hpp"
 #include "player.hpp"
 #include "user_input.hpp"
 #include "view.hpp"
 #include "game_model.hpp"
+#include "field_snapshot.hpp"
 
 namespace game_controller {
 
-class GameController : public observer::IObserver {
-    using IGameField = game_field::IGameField;
+class GameController {
     using IGameFieldArea = game_field_area::IGameFieldArea;
     using IGameModel = game_model::IGameModel;
     using IUserInput = user_input::IUserInput;
     using IGameFieldAreaCurryFactory = factory::IGameFieldAreaCurryFactory;
     using DrawableGridCanvas = view::DrawableGridCanvas;
+    using FieldSnapshot = field_snapshot::FieldSnapshot;
+    using SnapshotPublisher = field_snapshot::SnapshotPublisher;
 
 public:
     GameController(
@@ -27,22 +30,38 @@ public:
         std::shared_ptr<IUserInput> input,
         std::shared_ptr<sf::RenderWindow> window,
         const std::unordered_map<int, sf::Color>& playersCreatureColors,
-        const std::shared_ptr<IGameField> field);
+        std::shared_ptr<SnapshotPublisher> snapshots);
 
-    void update(int event_t) override;
+public:
+    // события модели приходят через очередь и разбираются в потоке отрисовки
+    void on(const game_event::PlayerBetsCreatures& evt);
+    void on(const game_event::ErCalculated& evt);
+    void on(const game_event::WinnerDetermined& evt);
+    void on(const game_event::DrawDetermined&);
+
+public:
+    // модель считается в своём потоке; контроллер с частотой кадров
+    // читает ввод и рисует клетки, изменившиеся с прошлого кадра
     void game();
+    // очередь, которую нужно подписать на события модели
+    std::shared_ptr<game_event::ModelQueue> modelEvents() const noexcept;
 
 private:
+    void runFrames_(const std::atomic<bool>& modelFinished);
+    void renderFrame_();
     void redrawWindowNDisplay_();
-    void updateCellInGridCanvasInView_(int xidx, int yidx);
+    // перерисовать клетки, изменившиеся после прошлого снимка
+    void paintSnapshot_(const FieldSnapshot& snapshot);
+    void paintCell_(DrawableGridCanvas& grid, 
+        int xidx, int yidx, cell_storage::owner_t owner);
     std::shared_ptr<DrawableGridCanvas> getCanvasComp_();
-    void clearGridCanvas_();
     void restartController_();
     void notifyAboutWinner_(const std::string& name);
     void notifyAboutDraw_();
     void notifyAboutPlayerParticipation_(
         const std::string& name, int moveRemained);
-    void notifyAboutModelComputing_(int erRemained);
+    void notifyAboutModelComputing_(int erRemained,
+        const cell_storage::population_t& population);
     void setTextOnTextComp_(const std::string& txt);
     void drawCanvasBackground_();
 
@@ -52,9 +71,10 @@ private:
     std::shared_ptr<view::IDrawableComposite> view_;
     std::shared_ptr<IUserInput> input_;             
     std::shared_ptr<sf::RenderWindow> window_;      
-    const std::shared_ptr<IGameField> field_;
     std::unordered_map<int, sf::Color> playersCreatureColors_; 
-    bool gameModelSetupPhase_ = false; 
+    std::shared_ptr<SnapshotPublisher> snapshots_;
+    std::shared_ptr<game_event::ModelQueue> modelEvents_;
+    bool needsRedraw_ = true;
 };
 
 } // namespace game_controller
@@ -0,0 +1,23 @@
+#ifndef GAME_ENGINE_HPP
+#define GAME_ENGINE_HPP
+
+#include "game_field_area.hpp"
+#include "creature_strategy.hpp"
+#include "counter_rng.hpp"
+
+namespace game_engine {
+
+// рассчитывает следующее поколение в области и применяет его к полю;
+// равенство соседей разных игроков при рождении разрешается через rng
+struct IGameEngine {
+    virtual void computeEr(
+        game_field_area::IGameFieldArea& area,
+        const creature_strategy::TransitionTable& rule,
+        const counter_rng::CounterRng& rng) = 0;
+
+    virtual ~IGameEngine() = default;
+};
+
+} // namespace game_engine
+
+#endif // GAME_ENGINE_HPP
@@ -1,22 +1,90 @@
 #ifndef GAME_EVENT_HPP
 #define GAME_EVENT_HPP
 
+#include <memory>
+
+#include "cell_owner.hpp"
+#include "event_bus.hpp"
+#include "event_queue.hpp"
+
+namespace player {
+    class Player;
+} // namespace player
+
+namespace change_set {
+    class ChangeSet;
+} // namespace change_set
+
 namespace game_event {
 
-enum class event_t : int {
-    FIELD_CLEAR = 0,
-    CREATURE_REMOVE_IN_FIELD,
-    CREATURE_SET_IN_FIELD,
-    USER_ASKED_CLOSE,
-    USER_ASKED_RESTART,
-    USER_ASKED_SET_CREATURE,
-    WINNER_DETERMINATE,
-    DRAW_DETERMINATE,
-    PLAYER_BETS_CREATURES,
-    GAME_MODEL_CALCULATED_ER,
-    USER_INPUT_REQUIRED
+// события несут свои данные: обработчику не нужно
+// обращаться к источнику события
+
+// события поля
+struct FieldCleared {};
+
+// набор изменений можно сохранить и обработать позже
+struct CreatureSet {
+    std::shared_ptr<const change_set::ChangeSet> changes;
+};
+
+struct CreatureRemoved {
+    std::shared_ptr<const change_set::ChangeSet> changes;
+};
+
+// пакет изменений или поколение целиком
+struct ChangesApplied {
+    std::shared_ptr<const change_set::ChangeSet> changes;
+};
+
+// события модели
+struct PlayerBetsCreatures {
+    std::shared_ptr<player::Player> player;
+    int movesRemained;
+};
+
+struct ErCalculated {
+    int erRemained;
+    // количество существ каждого владельца на поле модели
+    cell_storage::population_t population;
 };
 
+struct WinnerDetermined {
+    std::shared_ptr<player::Player> winner;
+};
+
+struct DrawDetermined {};
+
+struct UserInputRequired {};
+
+// события ввода
+struct UserAskedClose {};
+
+struct UserAskedRestart {};
+
+struct UserAskedSetCreature {
+    int xidx;
+    int yidx;
+};
+
+using FieldBus = event_bus::EventBus<
+    FieldCleared, CreatureSet, CreatureRemoved, ChangesApplied>;
+
+using ModelBus = event_bus::EventBus<
+    PlayerBetsCreatures, ErCalculated, WinnerDetermined,
+    DrawDetermined, UserInputRequired>;
+
+using InputBus = event_bus::EventBus<
+    UserAskedClose, UserAskedRestart, UserAskedSetCreature>;
+
+// ввод, который поток отрисовки передаёт потоку модели
+using InputQueue = event_bus::EventQueue<
+    UserAskedClose, UserAskedRestart, UserAskedSetCreature>;
+
+// события модели, которые поток модели передаёт потоку отрисовки
+using ModelQueue = event_bus::EventQueue<
+    PlayerBetsCreatures, ErCalculated, WinnerDetermined, DrawDetermined>;
+
 } // namespace game_event
 
-#endif // GAME_EVENT_HPP
\ No newline at end of file
+#endif // GAME_EVENT_HPP
@@ -6,12 +6,20 @@
 #include <utility>
 #include <stdexcept>
 #include <array>
+#include <span>
 
 #include "game_event.hpp"
-#include "subject.hpp"
+#include "change_set.hpp"
 #include "creature_factory.hpp"
 #include "cell_factory.hpp"
+#include "cell_storage.hpp"
+#include "neighbor_table.hpp"
+#include "player_registry.hpp"
+#include "active_tiles.hpp"
 #include "figure.hpp"
+#include "figure_mask.hpp"
+#include "stencil.hpp"
+#include "topology.hpp"
 
 namespace player {
     class Player;
@@ -25,10 +33,25 @@ struct IGameField {
                         std::shared_ptr<player::Player> player) = 0;
     virtual void removeCreatureInCell(int xidx, int yidx) = 0;
     virtual bool hasCreatureInCell(int xidx, int yidx) const = 0;
+    // применить пакет изменений с одним оповещением:
+    // пустой владелец удаляет существо
+    virtual void applyChanges(
+        std::span<const cell_storage::change_t> changes) = 0;
     virtual std::map<const std::shared_ptr<player::Player>, int> 
         countCellNeighborsCreatures(int xidx, int yidx) const = 0;
+    virtual void countCellNeighborsCreatures(int xidx, int yidx,
+        cell_storage::neighbor_counts_t& count) const = 0;
     virtual void clear() = 0;
-    virtual std::pair<int, int> lastAffectedCell() const noexcept = 0;
+    // расчёт поколения: следующее состояние пишется во второй буфер,
+    // обмен буферов оповещает одним набором изменившихся клеток
+    virtual void beginGeneration() = 0;
+    virtual void setNextOwner(int xidx, int yidx, 
+        cell_storage::owner_t owner) noexcept = 0;
+    virtual void swapGeneration() = 0;
+    // плитки, которые нужно пересчитать в текущем поколении
+    virtual const active_tiles::ActiveTiles& activeTiles() const noexcept = 0;
+    // количество существ каждого владельца на поле
+    virtual const cell_storage::population_t& population() const noexcept = 0;
     virtual int width() const noexcept = 0;
     virtual int height() const noexcept = 0;
     
@@ -37,20 +60,40 @@ struct IGameField {
 
 class GameFieldWithFigure :
     public IGameField,
-    public std::enable_shared_from_this<GameFieldWithFigure>,
-    public subject::ISubject
+    public std::enable_shared_from_this<GameFieldWithFigure>
 {
 private:
-    using ISubject = subject::ISubject;
     using ICreatureFactory = factory::ICreatureFactory;
     using IFigure = figure::IFigure;
+    using ICellStorage = cell_storage::ICellStorage;
+    using NeighborTable = neighbor_table::NeighborTable;
 
 public:
     GameFieldWithFigure(
         int width, int height,
         std::unique_ptr<factory::ICreatureFactory> creatFactory,
         std::unique_ptr<factory::ICellFactory> cellFactory,
-        std::unique_ptr<IFigure> figure);
+        std::unique_ptr<IFigure> figure,
+        topology::topology_t topology = topology::topology_t::BOUNDED);
+    GameFieldWithFigure(
+        int width, int height,
+        std::unique_ptr<factory::ICreatureFactory> creatFactory,
+        std::unique_ptr<ICellStorage> storage,
+        std::unique_ptr<IFigure> figure,
+        topology::topology_t topology = topology::topology_t::BOUNDED);
+    // соседи клеток задаются шаблоном окрестности
+    template <stencil::stencil_type Stencil>
+    GameFieldWithFigure(
+        int width, int height,
+        std::unique_ptr<factory::ICreatureFactory> creatFactory,
+        std::unique_ptr<ICellStorage> storage,
+        std::unique_ptr<IFigure> figure,
+        Stencil,
+        topology::topology_t topology = topology::topology_t::BOUNDED) :
+        GameFieldWithFigure(width, height, 
+            std::move(creatFactory), std::move(storage), std::move(figure),
+            std::span<const stencil::offset_t>(Stencil::offsets), topology)
+    {}
     
 public:
     const creature::ICreature& getCreatureByCell(int xidx, int yidx) const override;
@@ -58,44 +101,111 @@ public:
             std::shared_ptr<player::Player> player) override;
     void removeCreatureInCell(int xidx, int yidx) override;
     bool hasCreatureInCell(int xidx, int yidx) const override;
+    void applyChanges(
+        std::span<const cell_storage::change_t> changes) override;
     std::map<const std::shared_ptr<player::Player>, int> 
         countCellNeighborsCreatures(int xidx, int yidx) const override;
+    void countCellNeighborsCreatures(int xidx, int yidx,
+        cell_storage::neighbor_counts_t& count) const override;
     void clear() override;
-    std::pair<int, int> lastAffectedCell() const noexcept override;
+    void beginGeneration() override;
+    void setNextOwner(int xidx, int yidx, 
+        cell_storage::owner_t owner) noexcept override;
+    void swapGeneration() override;
+    const active_tiles::ActiveTiles& activeTiles() const noexcept override;
+    const cell_storage::population_t& population() const noexcept override;
     int width() const noexcept override;
     int height() const noexcept override;
 
 public:
+    // зарегистрировать игрока и вернуть владельца для пакета изменений
+    cell_storage::owner_t registerPlayer(
+        std::shared_ptr<player::Player> player);
     bool isExcludedCell(int xidx, int yidx) const;
+    // владельцы и количества соседей клеток строки yidx, начиная 
+    // с xbegin, без проверки каждой клетки: отрезок должен лежать 
+    // в фигуре, например, браться из forEachSpan её маски
+    void readSpan(int yidx, int xbegin, 
+        std::span<cell_storage::owner_t> owners,
+        std::span<cell_storage::neighbor_counts_t> counts) const;
+    // фигура, растрированная при создании поля
+    const figure_mask::FigureMask& figureMask() const noexcept;
+    topology::topology_t topology() const noexcept;
+    const ICellStorage& storage() const noexcept;
+    const player::PlayerRegistry& players() const noexcept;
+    std::shared_ptr<const NeighborTable> neighborTable() const noexcept;
+    std::span<const stencil::offset_t> neighborOffsets() const noexcept;
+    // клетки, у которых помимо соседей окрестности есть дополнительные соседи
+    std::vector<std::pair<int, int>> cellsWithExtraNeighbors() const;
+    // количество существ в прямоугольнике поддерживается при изменении
+    // клеток; одинаковые прямоугольники делят один счётчик
+    int trackRegion(std::pair<int, int> upperLeftCorner,
+                    std::pair<int, int> lowerRightCorner);
+    void untrackRegion(int region);
+    const cell_storage::population_t& regionPopulation(int region) const;
+    // номер состояния клеток: растёт при каждом изменении поля,
+    // по нему движок узнаёт, что поле менялось не через него
+    std::uint64_t version() const noexcept;
 
 public:
-    void attach(std::shared_ptr<observer::IObserver> obs, int event_t) override;
-    void detach(std::weak_ptr<observer::IObserver> obs, int event_t) override;
+    game_event::FieldBus& events() noexcept;
+
+protected:
+    // добавить клетке соседей связанной с ней клетки
+    void linkNeighbors_(
+        const std::map<std::pair<int, int>, std::pair<int, int>>& links);
 
 private:
-    void notify(int event_t) override;
+    GameFieldWithFigure(
+        int width, int height,
+        std::unique_ptr<factory::ICreatureFactory> creatFactory,
+        std::unique_ptr<ICellStorage> storage,
+        std::unique_ptr<IFigure> figure,
+        std::span<const stencil::offset_t> neighborsPos,
+        topology::topology_t topology);
+
+private:
+    struct region_t {
+        std::pair<int, int> upperLeftCorner;
+        std::pair<int, int> lowerRightCorner;
+        // количество зон, следящих за прямоугольником; 0 - место свободно
+        int refs;
+        cell_storage::population_t population;
+    };
 
 private:
     void verifyThenThrowCellPos_(int xidx, int yidx) const;
+    void countOwnerChange_(int xidx, int yidx, 
+        cell_storage::owner_t from, cell_storage::owner_t to) noexcept;
+    // набор для следующего события Event из пула наборов;
+    // nullptr - у события нет обработчиков, и набор не собирается
+    template <class Event>
+    change_set::ChangeSet* beginChanges_();
+    template <class Event>
+    void fireChanges_();
     void fireFieldClear_();
-    void fireCreatureSet_();
-    void fireCreatureRemove_();
     void initField_(int width, int height);
-    void initCells_();
-    std::pair<int, int> clampToSphere_(int x, int y) const;
+    void initNeighborTable_();
     
 private:
-    std::vector<std::vector<std::unique_ptr<cell::ICell>>> field_;
-    std::pair<int, int> lastAffectedCell_ = {-1, -1};             
+    std::unique_ptr<ICellStorage> storage_;
+    std::shared_ptr<const NeighborTable> neighborTable_;
+    player::PlayerRegistry players_;
+    active_tiles::ActiveTiles tiles_;
+    game_event::FieldBus events_;
+    change_set::ChangeSetPool changesPool_;
+    std::shared_ptr<change_set::ChangeSet> changes_;
+    std::uint64_t changeSequence_ = 0;
+    std::uint64_t version_ = 0;
+    cell_storage::population_t population_{};
+    std::vector<region_t> regions_;
+    // изменения строки при обмене буферов, память переиспользуется
+    std::vector<cell_storage::row_change_t> rowChanges_;
     std::unique_ptr<factory::ICreatureFactory> creatFactory_;     
-    std::unique_ptr<factory::ICellFactory> cellFactory_;          
     std::unique_ptr<IFigure> figure_;
-
-    static constexpr std::array<const std::pair<int, int>, 8> neighborsPos_ {{
-        {-1,  -1}, {0, -1}, {1, -1},
-        {-1,   0},          {1,  0},
-        {-1,   1}, {0,  1}, {1,  1}  
-    }};
+    std::vector<stencil::offset_t> neighborsPos_;
+    figure_mask::FigureMask mask_;
+    topology::topology_t topology_;
 
 };
 
@@ -15,22 +15,62 @@ struct IGameFieldArea {
     
     virtual void lock() noexcept = 0;
     virtual void unlock() noexcept = 0;
+    virtual bool isLocked() const noexcept = 0;
     virtual bool isCellAvailable(int xidx, int yidx) const = 0;
     virtual void setCreatureInCell(int xidx, int yidx, 
                 std::shared_ptr<player::Player> player) = 0;
     virtual void removeCreatureInCell(int xidx, int yidx) = 0;
+    // все клетки пакета должны быть доступны
+    virtual void applyChanges(
+        std::span<const cell_storage::change_t> changes) = 0;
     virtual bool hasCreatureInCell(int xidx, int yidx) const = 0;
     virtual const creature::ICreature& 
         getCreatureByCell(int xidx, int yidx) const = 0;
     virtual std::map<const std::shared_ptr<player::Player>, int> 
         countCellNeighborsCreatures(int xidx, int yidx) const = 0;
+    virtual void countCellNeighborsCreatures(int xidx, int yidx,
+        cell_storage::neighbor_counts_t& count) const = 0;
+    // владельцы и количества соседей отрезка из forEachAvailableSpan:
+    // один вызов на отрезок, клетки уже проверены и читаются без проверок
+    virtual void readSpan(int yidx, int xbegin,
+        std::span<cell_storage::owner_t> owners,
+        std::span<cell_storage::neighbor_counts_t> counts) const = 0;
     virtual std::set<std::shared_ptr<player::Player>> 
         checkCreatureInArea() const = 0;
+    // количество существ каждого владельца в прямоугольнике зоны;
+    // у закрытой зоны - нули
+    virtual const cell_storage::population_t& population() const = 0;
     virtual void clear() = 0;
+    virtual void beginGeneration() = 0;
+    virtual void setNextOwner(int xidx, int yidx, 
+        cell_storage::owner_t owner) noexcept = 0;
+    virtual void swapGeneration() = 0;
+    virtual const active_tiles::ActiveTiles& activeTiles() const noexcept = 0;
     virtual std::pair<int, int> upperLeftCorner() const noexcept = 0;
     virtual std::pair<int, int> lowerRightCorner() const noexcept = 0;
     virtual int width() const noexcept = 0;
     virtual int height() const noexcept = 0;
+    virtual const figure_mask::FigureMask& figureMask() const noexcept = 0;
+
+    // вызвать f(begin, end) для отрезков доступных клеток [begin, end)
+    // строки yidx внутри столбцов [x0, x1) - без проверки каждой клетки
+    template <class F>
+    void forEachAvailableSpan(int yidx, int x0, int x1, F&& f) const {
+        if (isLocked() || 
+            yidx < upperLeftCorner_.second || 
+            yidx > lowerRightCorner_.second) 
+        {
+            return;
+        }
+        figureMask().forEachSpan(yidx, 
+            std::max(x0, upperLeftCorner_.first),
+            std::min(x1, lowerRightCorner_.first + 1), f);
+    }
+    template <class F>
+    void forEachAvailableSpan(int yidx, F&& f) const {
+        forEachAvailableSpan(yidx, 
+            upperLeftCorner_.first, lowerRightCorner_.first + 1, f);
+    }
 
     virtual ~IGameFieldArea() = default;
 
@@ -48,24 +88,43 @@ public:
         std::shared_ptr<GameFieldWithFigure> field,
         std::pair<int, int> upperLeftCorner, 
         std::pair<int, int> lowerRightCorner);
+    GameFieldWithFigureArea(const GameFieldWithFigureArea&) = delete;
+    GameFieldWithFigureArea& operator=(
+        const GameFieldWithFigureArea&) = delete;
+    ~GameFieldWithFigureArea() override;
 
     void lock() noexcept override;
     void unlock() noexcept override;
+    bool isLocked() const noexcept override;
     bool isCellAvailable(int xidx, int yidx) const override;
     void setCreatureInCell(int xidx, int yidx, 
             std::shared_ptr<player::Player> player) override;
     void removeCreatureInCell(int xidx, int yidx) override;
+    void applyChanges(
+        std::span<const cell_storage::change_t> changes) override;
     bool hasCreatureInCell(int xidx, int yidx) const override;
     const ICreature& getCreatureByCell(int xidx, int yidx) const override;
     std::map<const std::shared_ptr<player::Player>, int> 
         countCellNeighborsCreatures(int xidx, int yidx) const override;
+    void countCellNeighborsCreatures(int xidx, int yidx,
+        cell_storage::neighbor_counts_t& count) const override;
+    void readSpan(int yidx, int xbegin,
+        std::span<cell_storage::owner_t> owners,
+        std::span<cell_storage::neighbor_counts_t> counts) const override;
     std::set<std::shared_ptr<player::Player>> 
         checkCreatureInArea() const override;
+    const cell_storage::population_t& population() const override;
     void clear() override;
+    void beginGeneration() override;
+    void setNextOwner(int xidx, int yidx, 
+        cell_storage::owner_t owner) noexcept override;
+    void swapGeneration() override;
+    const active_tiles::ActiveTiles& activeTiles() const noexcept override;
     std::pair<int, int> upperLeftCorner() const noexcept override;
     std::pair<int, int> lowerRightCorner() const noexcept override;
     int width() const noexcept override;
     int height() const noexcept override;
+    const figure_mask::FigureMask& figureMask() const noexcept override;
 
 private:
     void verifyThenThrowCellPos_(int xidx, int yidx) const;
@@ -73,6 +132,8 @@ private:
 private:
     bool isLocked_ = true; 
     std::shared_ptr<GameFieldWithFigure> field_; 
+    // счётчик существ прямоугольника зоны в поле
+    int region_;
 };
 
 } // namespace game_field_area
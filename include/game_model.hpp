@@ -5,13 +5,19 @@
 #include <utility>
 #include <tuple>
 #include <map>
+#include <array>
+#include <vector>
+#include <chrono>
 
 #include "creature_factory.hpp"
 #include "game_field_area_factory.hpp"
 #include "game_field_area.hpp"
-#include "observer.hpp"
+#include "game_event.hpp"
 #include "player.hpp"
 #include "creature_strategy.hpp"
+#include "game_engine.hpp"
+#include "thread_pool.hpp"
+#include "counter_rng.hpp"
 
 namespace game_model {
 
@@ -21,19 +27,23 @@ struct IGameModel {
     virtual std::shared_ptr<player::Player> winnerPlayer() const noexcept = 0;
     virtual int movesRemained() const noexcept = 0;
     virtual int erRemained() const noexcept = 0;
+    virtual game_event::ModelBus& events() noexcept = 0;
+    virtual std::shared_ptr<game_event::InputQueue> inbox() const noexcept = 0;
 
     virtual ~IGameModel() = default;
 };
 
 class GameModel : 
     public IGameModel,
-    public observer::IObserver,
-    public subject::ISubject,
     public std::enable_shared_from_this<GameModel>
 {
     using IGameFieldArea = game_field_area::IGameFieldArea;
     using IGameFieldAreaCurryFactory = factory::IGameFieldAreaCurryFactory;
     using ICreatureStrategy = creature_strategy::ICreatureStrategy;
+    using TransitionTable = creature_strategy::TransitionTable;
+    using IGameEngine = game_engine::IGameEngine;
+    // изменение клетки в следующем поколении
+    using change_t = cell_storage::change_t;
 
 public:
     GameModel(
@@ -43,19 +53,17 @@ public:
         std::unique_ptr<IGameFieldArea> area, 
         std::unique_ptr<IGameFieldAreaCurryFactory> areaFactory,
         const std::vector<std::shared_ptr<player::Player>>& players,
-        std::unique_ptr<ICreatureStrategy> creatStrategy);
+        std::unique_ptr<ICreatureStrategy> creatStrategy,
+        std::unique_ptr<IGameEngine> engine = nullptr,
+        std::unique_ptr<thread_pool::ThreadPool> pool = nullptr);
     
-public: 
-    void attach(
-        std::shared_ptr<observer::IObserver> obs, int event_t) override;
-    void detach(
-        std::weak_ptr<observer::IObserver> obs, int event_t) override;
-
-private:
-    void notify(int event_t) override;
-
 public:
-    void update(int event_t) override;
+    // обработчики событий ввода и поля
+    void on(const game_event::UserAskedClose&);
+    void on(const game_event::UserAskedRestart&);
+    void on(const game_event::UserAskedSetCreature& evt);
+    void on(const game_event::CreatureSet&);
+    void on(const game_event::CreatureRemoved&);
 
 public:
     void game() override;
@@ -63,6 +71,16 @@ public:
     std::shared_ptr<player::Player> winnerPlayer() const noexcept override;
     int movesRemained() const noexcept override;
     int erRemained() const noexcept override;
+    game_event::ModelBus& events() noexcept override;
+    // очередь ввода из другого потока: события разбираются
+    // в потоке game(), пока модель ждёт ввод или делает паузу
+    std::shared_ptr<game_event::InputQueue> inbox() const noexcept override;
+    // счётчики пула для настройки, nullptr - поколение считается без пула
+    const thread_pool::ThreadPool* threadPool() const noexcept;
+    // зерно выбора среди равных соседей: с одним зерном
+    // из одного состояния получаются одинаковые поколения
+    void setSeed(std::uint64_t seed) noexcept;
+    std::uint64_t seed() const noexcept;
 
 private:
     void giveAreasForTwoPlayers_();
@@ -70,6 +88,11 @@ private:
     void setupFieldForPlayer_(int creatureNumber, 
             std::shared_ptr<player::Player> player);
     void computeErs_(int erCount);
+    // разобрать ввод, дождавшись его не дольше кадра
+    void awaitInput_();
+    // пауза между поколениями: ввод разбирается,
+    // закрытие и перезапуск прерывают паузу
+    void pause_(std::chrono::milliseconds period);
 #ifdef TEST
 public:
 #endif
@@ -79,8 +102,12 @@ public:
 #ifdef TEST
 private:
 #endif
-    void computeAside_();
-    void applyNClearAside_();
+    void computeNextGeneration_();
+    void collectTileTasks_();
+    void computeTile_(int tileX, int tileY, 
+        std::vector<change_t>& changes) const;
+    cell_storage::owner_t chooseOwner_(
+        const cell_storage::neighbor_counts_t& ne, int x, int y) const;
     void restartModel_();
     void fireWinnerDeterminate_();
     void fireThereWasDraw_();
@@ -92,13 +119,20 @@ private:
     const int creatNumberFirstTime_;                          
     const int creatNumber_;                                   
     const int erCount_;                                       
+    game_event::ModelBus events_;
+    std::shared_ptr<game_event::InputQueue> inbox_;
     std::unique_ptr<IGameFieldAreaCurryFactory> areaFactory_; 
     std::unique_ptr<IGameFieldArea> area_;                    
-    std::unique_ptr<ICreatureStrategy> creatStrategy_;
-    
-    // deferred field changes
-    std::vector<
-        std::tuple< std::shared_ptr<player::Player>, bool, int, int>> aside_;
+    // если движок не задан, поколение считается через computeNextGeneration_
+    std::unique_ptr<IGameEngine> engine_;
+    // если пул не задан, поколение считается в вызывающем потоке
+    std::unique_ptr<thread_pool::ThreadPool> pool_;
+    // активные плитки зоны - задачи поколения
+    std::vector<std::pair<int, int>> tileTasks_;
+    // буфер изменений каждого потока пула
+    std::vector<std::vector<change_t>> workerChanges_;
+    // стратегия опрашивается один раз при создании модели
+    const TransitionTable rule_;
         
     std::vector<std::shared_ptr<player::Player>> players_; 
 
@@ -111,6 +145,11 @@ private:
     std::shared_ptr<player::Player> winnerPlayer_;       
     int curPlayerCreatNumber_;                           
     int erRemained_;                                     
+
+    counter_rng::CounterRng rng_;
+    // генератор рассчитываемого поколения
+    counter_rng::CounterRng generationRng_;
+    std::uint64_t generation_ = 0;
 };
 
 } // namespace game_model
@@ -0,0 +1,72 @@
+#ifndef GRID_ENGINE_HPP
+#define GRID_ENGINE_HPP
+
+#include <array>
+#include <vector>
+#include <tuple>
+#include <span>
+
+#include "game_engine.hpp"
+#include "game_field.hpp"
+#include "stencil.hpp"
+
+namespace game_engine {
+
+// общая часть движков, читающих поле напрямую из FlatCellStorage:
+// наследник рассчитывает изменения для клеток с соседями окрестности,
+// клетки с дополнительными соседями пересчитываются через поле
+class GridGameEngine : public IGameEngine {
+protected:
+    using GameFieldWithFigure = game_field::GameFieldWithFigure;
+    using FlatCellStorage = cell_storage::FlatCellStorage;
+    using TransitionTable = creature_strategy::TransitionTable;
+    using owner_t = cell_storage::owner_t;
+    using owner_counts_t = std::array<int, cell_storage::maxPlayers + 1>;
+
+public:
+    // окрестность движка должна совпадать с окрестностью поля
+    GridGameEngine(std::shared_ptr<GameFieldWithFigure> field,
+        std::span<const stencil::offset_t> neighborhood = 
+            stencil::Moore::offsets);
+
+public:
+    void computeEr(
+        game_field_area::IGameFieldArea& area,
+        const TransitionTable& rule,
+        const counter_rng::CounterRng& rng) override;
+
+protected:
+    virtual void computeChanges_(const FlatCellStorage& storage) = 0;
+    // изменения поколения применены к полю: changes_ ещё не очищены
+    virtual void changesApplied_(const FlatCellStorage&) {}
+    // владелец с максимальным количеством соседей, 
+    // из равных - выбранный генератором поколения по клетке
+    owner_t chooseOwner_(const owner_counts_t& count, int x, int y) const;
+
+private:
+    const FlatCellStorage& flatStorage_() const;
+    // клетки с дополнительными соседями собираются заново 
+    // только при смене таблицы соседей поля
+    void cacheExtraCells_();
+    void computeExtraNeighborsChanges_(const FlatCellStorage& storage);
+    void applyChanges_(game_field_area::IGameFieldArea& area);
+
+protected:
+    std::shared_ptr<GameFieldWithFigure> field_;
+    // правило и генератор текущего поколения
+    TransitionTable rule_;
+    counter_rng::CounterRng rng_;
+    // отложенные изменения: x, y, новый владелец
+    std::vector<cell_storage::change_t> changes_;
+
+private:
+    std::shared_ptr<const neighbor_table::NeighborTable> extraTable_;
+    // индексы клеток с дополнительными соседями без повторов
+    // и отметка каждой клетки поля для фильтра изменений
+    std::vector<std::uint32_t> extraCells_;
+    std::vector<bool> isExtra_;
+};
+
+} // namespace game_engine
+
+#endif // GRID_ENGINE_HPP
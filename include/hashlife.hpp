@@ -0,0 +1,129 @@
+#ifndef HASHLIFE_HPP
+#define HASHLIFE_HPP
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+
+#include "cell_owner.hpp"
+
+namespace hashlife {
+
+using owner_t = cell_storage::owner_t;
+using rule_t = std::array<bool, 9>;
+using coord_t = std::int64_t;
+
+// бесконечное поле в виде квадродерева с общими одинаковыми
+// поддеревьями; результат поддерева запоминается, поэтому
+// за один шаг можно продвинуться на 2^k поколений.
+// цветной вариант: не больше двух владельцев на всё поле
+class Universe {
+public:
+    static constexpr int maxColors = 2;
+
+public:
+    Universe(const rule_t& birth, const rule_t& survive);
+
+public:
+    void setCell(coord_t xidx, coord_t yidx, owner_t owner);
+    owner_t cell(coord_t xidx, coord_t yidx) const;
+    // заполнить прямоугольник [0, width) x [0, height) построчным буфером
+    void load(int width, int height, const std::vector<owner_t>& cells);
+    // выгрузить прямоугольник [0, width) x [0, height) в построчный буфер
+    void store(int width, int height, std::vector<owner_t>& cells) const;
+    // удалить клетки вне прямоугольника [x0, x1) x [y0, y1)
+    void clip(coord_t x0, coord_t y0, coord_t x1, coord_t y1);
+    // продвинуться на 2^stepLog2 поколений
+    void step(int stepLog2);
+    // запомнить текущее поле, изменения считаются относительно него
+    void checkpoint();
+    // дописать клетки прямоугольника [0, width) x [0, height),
+    // изменившиеся после checkpoint: x, y, новый владелец. одинаковые
+    // поддеревья общие, поэтому обходятся только изменившиеся части
+    void changesSinceCheckpoint(int width, int height,
+        std::vector<cell_storage::change_t>& changes);
+
+public:
+    // количество существ владельца в прямоугольнике [x0, x1) x [y0, y1)
+    std::uint64_t population(owner_t owner,
+        coord_t x0, coord_t y0, coord_t x1, coord_t y1) const;
+    std::uint64_t population() const noexcept;
+    // владельцы, чьи существа есть в прямоугольнике
+    std::vector<owner_t> owners(
+        coord_t x0, coord_t y0, coord_t x1, coord_t y1) const;
+    // владелец родившейся клетки всегда выбирается однозначно
+    bool isDeterministic() const noexcept;
+    // есть ли у владельца цвет в дереве
+    bool hasColor(owner_t owner) const noexcept;
+    std::uint64_t generation() const noexcept;
+    std::size_t nodeCount() const noexcept;
+
+private:
+    using node_t = std::uint32_t;
+
+    struct Node {
+        // nw, ne, sw, se; у листьев не используются
+        std::array<node_t, 4> child;
+        int level;
+        std::array<std::uint64_t, maxColors> pop;
+    };
+
+    struct NodeKeyHash {
+        std::size_t operator()(const std::array<node_t, 4>& key) const noexcept;
+    };
+
+private:
+    node_t join_(node_t nw, node_t ne, node_t sw, node_t se);
+    node_t empty_(int level);
+    node_t leaf_(int color) const noexcept;
+    std::uint64_t totalPop_(node_t node) const noexcept;
+    int colorOf_(owner_t owner) const noexcept;
+    int addColor_(owner_t owner);
+    coord_t half_() const noexcept;
+
+    void expand_();
+    // узел на уровень больше с тем же центром
+    node_t grow_(node_t node);
+    bool isCentered_() const noexcept;
+    node_t successor_(node_t node, int stepLog2);
+    node_t life4x4_(node_t node);
+    node_t set_(node_t node, coord_t xidx, coord_t yidx, int color);
+    node_t build_(int level, coord_t xidx, coord_t yidx,
+        int width, int height, const std::vector<owner_t>& cells);
+    void store_(node_t node, coord_t xidx, coord_t yidx,
+        int width, int height, std::vector<owner_t>& cells) const;
+    node_t clip_(node_t node, coord_t xidx, coord_t yidx,
+        coord_t x0, coord_t y0, coord_t x1, coord_t y1);
+    std::uint64_t population_(node_t node, int color,
+        coord_t xidx, coord_t yidx,
+        coord_t x0, coord_t y0, coord_t x1, coord_t y1) const;
+    void diff_(node_t from, node_t to, coord_t xidx, coord_t yidx,
+        int width, int height,
+        std::vector<cell_storage::change_t>& changes) const;
+    void collectGarbage_();
+    node_t copyReachable_(node_t node, std::vector<Node>& nodes,
+        std::unordered_map<node_t, node_t>& remap) const;
+
+private:
+    rule_t birth_;
+    rule_t survive_;
+    // листья 0..maxColors - клетки соответствующего цвета
+    std::vector<Node> nodes_;
+    std::unordered_map<std::array<node_t, 4>, node_t, NodeKeyHash> index_;
+    // результат узла: ключ - (узел << 8) | stepLog2
+    std::unordered_map<std::uint64_t, node_t> results_;
+    std::vector<node_t> empties_;
+    // владелец каждого цвета, 0 - цвет свободен
+    std::array<owner_t, maxColors + 1> colorOwner_{};
+    node_t root_;
+    int rootLevel_;
+    // корень, запомненный checkpoint; уровень хранится в узле
+    std::optional<node_t> checkpoint_;
+    std::uint64_t generation_ = 0;
+};
+
+} // namespace hashlife
+
+#endif // HASHLIFE_HPP
@@ -0,0 +1,74 @@
+#ifndef HASHLIFE_ENGINE_HPP
+#define HASHLIFE_ENGINE_HPP
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "game_engine.hpp"
+#include "game_field.hpp"
+#include "hashlife.hpp"
+
+namespace game_engine {
+
+// поколение считается через HashLife: за вызов делается 2^stepLog2
+// поколений. квадродерево живёт между вызовами вместе с запомненными
+// результатами и заново загружается из поля, только если поле менялось
+// не через движок. если правило, топология или количество игроков
+// не поддерживаются - считает запасной движок.
+// поддерживается только поле с несоединёнными краями
+class HashLifeGameEngine : public IGameEngine {
+    using GameFieldWithFigure = game_field::GameFieldWithFigure;
+    using TransitionTable = creature_strategy::TransitionTable;
+    using owner_t = cell_storage::owner_t;
+
+public:
+    HashLifeGameEngine(
+        std::shared_ptr<GameFieldWithFigure> field,
+        std::unique_ptr<IGameEngine> fallback,
+        int stepLog2 = 0);
+
+public:
+    void computeEr(
+        game_field_area::IGameFieldArea& area,
+        const TransitionTable& rule,
+        const counter_rng::CounterRng& rng) override;
+
+public:
+    // поддерживает ли HashLife текущее поле и правило
+    bool isSupported(const TransitionTable& rule);
+    // дерево после последнего шага, если он был сделан через HashLife
+    const hashlife::Universe* universe() const noexcept;
+    // владельцы существ в области по дереву последнего шага
+    std::vector<owner_t> ownersInArea(
+        const game_field_area::IGameFieldArea& area) const;
+
+private:
+    void loadRule_(const TransitionTable& rule);
+    bool isFieldSupported_();
+    // привести дерево к полю, если поле менялось не через движок
+    void syncUniverse_();
+    void loadCells_();
+    // прыжки по 2^j поколений, пока существа не доходят до края
+    void advance_();
+    bool staysInside_(int stepLog2) const;
+    void applyChanges_(game_field_area::IGameFieldArea& area);
+
+private:
+    std::shared_ptr<GameFieldWithFigure> field_;
+    std::unique_ptr<IGameEngine> fallback_;
+    int stepLog2_;
+    hashlife::rule_t birth_{};
+    hashlife::rule_t survive_{};
+    std::vector<owner_t> cells_;
+    std::vector<cell_storage::change_t> changes_;
+    std::optional<hashlife::Universe> universe_;
+    // правило дерева и состояние поля, которое дерево повторяет
+    hashlife::rule_t universeBirth_{};
+    hashlife::rule_t universeSurvive_{};
+    std::uint64_t universeVersion_ = 0;
+};
+
+} // namespace game_engine
+
+#endif // HASHLIFE_ENGINE_HPP
@@ -0,0 +1,38 @@
+#ifndef NEIGHBOR_KERNEL_HPP
+#define NEIGHBOR_KERNEL_HPP
+
+#include <cstdint>
+
+namespace neighbor_kernel {
+
+enum class kernel_t : int {
+    SCALAR = 0,
+    SSE2,
+    AVX2
+};
+
+// лучшая реализация, которую поддерживает процессор
+kernel_t activeKernel() noexcept;
+bool isKernelSupported(kernel_t kernel) noexcept;
+
+// сумма восьми соседей для каждой клетки строки байтовой сетки:
+// above, row, below указывают на клетку 0 своих строк,
+// у каждой строки есть по одной дополнительной клетке слева и справа
+void sumRowNeighbors(
+    const std::uint8_t* above,
+    const std::uint8_t* row,
+    const std::uint8_t* below,
+    std::uint8_t* out,
+    int width);
+
+void sumRowNeighbors(
+    kernel_t kernel,
+    const std::uint8_t* above,
+    const std::uint8_t* row,
+    const std::uint8_t* below,
+    std::uint8_t* out,
+    int width);
+
+} // namespace neighbor_kernel
+
+#endif // NEIGHBOR_KERNEL_HPP
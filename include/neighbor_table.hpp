@@ -0,0 +1,46 @@
+#ifndef NEIGHBOR_TABLE_HPP
+#define NEIGHBOR_TABLE_HPP
+
+#include <cstdint>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace neighbor_table {
+
+// соседи всех клеток поля в формате CSR: клетки нумеруются построчно,
+// соседи клетки i - indices[offsets[i] .. offsets[i + 1])
+class NeighborTable {
+public:
+    NeighborTable(
+        int width, int height,
+        std::vector<std::uint32_t> offsets,
+        std::vector<std::uint32_t> indices);
+
+public:
+    // таблица, в которой к соседям клетки добавлены соседи связанной клетки
+    NeighborTable withLinks(
+        const std::map<std::pair<int, int>, std::pair<int, int>>& links) const;
+    // обратная таблица: соседи клетки i - клетки, соседом которых она является
+    NeighborTable transposed() const;
+    std::span<const std::uint32_t> neighbors(std::uint32_t cell) const noexcept;
+    std::uint32_t index(int xidx, int yidx) const noexcept;
+    // клетки, у которых есть дополнительные соседи
+    const std::vector<std::uint32_t>& linkedCells() const noexcept;
+    const std::vector<std::uint32_t>& offsets() const noexcept;
+    const std::vector<std::uint32_t>& indices() const noexcept;
+    int width() const noexcept;
+    int height() const noexcept;
+
+private:
+    int width_;
+    int height_;
+    std::vector<std::uint32_t> offsets_;
+    std::vector<std::uint32_t> indices_;
+    std::vector<std::uint32_t> linkedCells_;
+};
+
+} // namespace neighbor_table
+
+#endif // NEIGHBOR_TABLE_HPP
@@ -5,7 +5,6 @@
 #include <string>
 
 #include "user_input.hpp"
-#include "observer.hpp"
 #include "game_event.hpp"
 #include "game_field_area.hpp"
 
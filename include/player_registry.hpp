@@ -0,0 +1,40 @@
+#ifndef PLAYER_REGISTRY_HPP
+#define PLAYER_REGISTRY_HPP
+
+#include <memory>
+#include <array>
+
+#include "cell_owner.hpp"
+#include "creature_factory.hpp"
+
+namespace player {
+
+class Player;
+
+// игроки, чьи существа стоят на поле: клетки хранят только owner_t,
+// игрок и его существо получаются через реестр на границе API
+class PlayerRegistry {
+    using owner_t = cell_storage::owner_t;
+
+public:
+    // зарегистрировать игрока при первом обращении и вернуть его владельца
+    owner_t registerPlayer(
+        std::shared_ptr<Player> player,
+        const factory::ICreatureFactory& creatFactory);
+    bool contains(owner_t owner) const noexcept;
+    std::shared_ptr<Player> player(owner_t owner) const;
+    const creature::ICreature& creature(owner_t owner) const;
+    
+public:
+    static owner_t ownerOf(const Player& player);
+
+private:
+    // одно существо на каждого владельца
+    std::array<
+        std::unique_ptr<creature::ICreature>, 
+        cell_storage::maxPlayers + 1> creatures_;
+};
+
+} // namespace player
+
+#endif // PLAYER_REGISTRY_HPP
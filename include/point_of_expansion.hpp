@@ -13,12 +13,15 @@ public:
         int width, int height, 
         std::unique_ptr<factory::ICreatureFactory> creatFactory,
         std::unique_ptr<factory::ICellFactory> cellFactory,
-        std::unique_ptr<figure::IFigure> figure);
+        std::unique_ptr<figure::IFigure> figure,
+        topology::topology_t topology = topology::topology_t::BOUNDED);
+    GamefieldWithFigureAndTriangularNeighbors(
+        int width, int height, 
+        std::unique_ptr<factory::ICreatureFactory> creatFactory,
+        std::unique_ptr<cell_storage::ICellStorage> storage,
+        std::unique_ptr<figure::IFigure> figure,
+        topology::topology_t topology = topology::topology_t::BOUNDED);
 
-public:
-    std::map<const std::shared_ptr<player::Player>, int> 
-        countCellNeighborsCreatures(int xidx, int yidx) const override;
-    
 private:
     void computeAddNeighbors_();
 
@@ -0,0 +1,55 @@
+#ifndef STENCIL_HPP
+#define STENCIL_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <span>
+
+namespace stencil {
+
+// смещение соседа относительно клетки
+struct offset_t {
+    int dx;
+    int dy;
+
+    constexpr bool operator==(const offset_t&) const = default;
+};
+
+// окрестность клетки, известная при компиляции
+template <offset_t... Offsets>
+struct Stencil {
+    static constexpr int size = sizeof...(Offsets);
+    static constexpr std::array<offset_t, size> offsets{ Offsets... };
+    // наибольшее удаление соседа по любой из осей
+    static constexpr int radius = std::max({ 0,
+        std::max(Offsets.dx, -Offsets.dx)...,
+        std::max(Offsets.dy, -Offsets.dy)... });
+
+    // вызвать f для каждого смещения, цикл раскрывается при компиляции
+    template <class F>
+    static constexpr void forEach(F&& f) {
+        (f(Offsets), ...);
+    }
+};
+
+using Moore = Stencil<
+    offset_t{ -1, -1 }, offset_t{ 0, -1 }, offset_t{ 1, -1 },
+    offset_t{ -1,  0 },                    offset_t{ 1,  0 },
+    offset_t{ -1,  1 }, offset_t{ 0,  1 }, offset_t{ 1,  1 }>;
+
+using VonNeumann = Stencil<
+                        offset_t{ 0, -1 },
+    offset_t{ -1,  0 },                    offset_t{ 1,  0 },
+                        offset_t{ 0,  1 }>;
+
+// окрестность, заданная шаблоном: Moore, VonNeumann, ...
+template <class T>
+concept stencil_type = requires {
+    { T::size } -> std::convertible_to<int>;
+    { std::span<const offset_t>(T::offsets) };
+};
+
+} // namespace stencil
+
+#endif // STENCIL_HPP
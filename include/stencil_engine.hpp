@@ -0,0 +1,88 @@
+#ifndef STENCIL_ENGINE_HPP
+#define STENCIL_ENGINE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "grid_engine.hpp"
+#include "stencil.hpp"
+
+namespace game_engine {
+
+// окрестность - параметр шаблона: подсчёт соседей раскрывается
+// при компиляции для каждой окрестности. поле хранится сеткой
+// с рамкой шириной в радиус окрестности, рамка заполняется по топологии
+// поля раз за поколение, поэтому проверок границ нет
+template <stencil::stencil_type Stencil>
+class StencilGameEngine : public GridGameEngine {
+public:
+    StencilGameEngine(std::shared_ptr<GameFieldWithFigure> field) :
+        GridGameEngine(field, Stencil::offsets)
+    {}
+
+private:
+    void computeChanges_(const FlatCellStorage& storage) override {
+        loadGrid_(storage);
+        changes_.clear();
+
+        for (int y = 0; y < height_; ++y) {
+            const owner_t* cell = grid_.data() 
+                + static_cast<std::size_t>(y + radius) * stride_ + radius;
+            for (int x = 0; x < width_; ++x, ++cell) {
+                int neSum = 0;
+                Stencil::forEach([&] (stencil::offset_t o) {
+                    neSum += cell[o.dy * stride_ + o.dx] 
+                             != cell_storage::emptyOwner;
+                });
+                bool isAlive = *cell != cell_storage::emptyOwner;
+                if (rule_.next(isAlive, neSum) == isAlive) continue;
+                if (isAlive) {
+                    changes_.emplace_back(x, y, cell_storage::emptyOwner);
+                    continue;
+                }
+                // для рождения нужны соседи каждого игрока
+                owner_counts_t count{};
+                Stencil::forEach([&] (stencil::offset_t o) {
+                    ++count[cell[o.dy * stride_ + o.dx]];
+                });
+                auto own = chooseOwner_(count, x, y);
+                if (own != cell_storage::emptyOwner) {
+                    changes_.emplace_back(x, y, own);
+                }
+            }
+        }
+    }
+
+    void loadGrid_(const FlatCellStorage& storage) {
+        width_ = storage.width();
+        height_ = storage.height();
+        stride_ = width_ + 2 * radius;
+        grid_.resize(static_cast<std::size_t>(stride_) 
+                     * (height_ + 2 * radius));
+
+        auto&& owners = storage.owners();
+        for (int y = 0; y < height_; ++y) {
+            const owner_t* src = owners.data() 
+                + static_cast<std::size_t>(y) * width_;
+            std::copy(src, src + width_, grid_.data() 
+                + static_cast<std::size_t>(y + radius) * stride_ + radius);
+        }
+        topology::fillGhostBorder(grid_.data(), width_, height_, radius,
+            field_->topology(), cell_storage::emptyOwner);
+    }
+
+private:
+    static constexpr int radius = Stencil::radius;
+
+    int width_ = 0;
+    int height_ = 0;
+    int stride_ = 0;
+    std::vector<owner_t> grid_;
+};
+
+using MooreGameEngine = StencilGameEngine<stencil::Moore>;
+using VonNeumannGameEngine = StencilGameEngine<stencil::VonNeumann>;
+
+} // namespace game_engine
+
+#endif // STENCIL_ENGINE_HPP
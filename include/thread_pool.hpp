@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace thread_pool {
+
+// постоянные рабочие потоки для параллельных циклов;
+// вызывающий поток работает наравне с ними под номером 0.
+// задачи раздаются по очередям потоков, освободившийся поток
+// крадёт задачи из начала чужих очередей
+class ThreadPool {
+public:
+    // счётчики для настройки размера задач
+    struct Stats {
+        std::uint64_t tasks = 0;
+        // задачи, взятые из чужих очередей
+        std::uint64_t steals = 0;
+        // время без работы до конца цикла
+        std::chrono::nanoseconds idle{0};
+    };
+
+public:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+    // выполнить task(i, worker) для всех i из [0, taskCount) 
+    // и дождаться окончания
+    void parallelFor(int taskCount, 
+        const std::function<void(int task, int worker)>& task);
+    int threadCount() const noexcept;
+    Stats stats() const;
+    const std::vector<Stats>& workerStats() const noexcept;
+    void resetStats() noexcept;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+private:
+    void workerLoop_(int worker);
+    void runTasks_(int worker);
+    bool popOwn_(int worker, int& task);
+    bool steal_(int worker, int& task);
+
+private:
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<Stats> stats_;
+    std::vector<std::chrono::steady_clock::time_point> finish_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int, int)>* task_ = nullptr;
+    // рабочие, ещё не закончившие текущий цикл
+    int busy_ = 0;
+    std::uint64_t job_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
+
+} // namespace thread_pool
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,66 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+namespace topology {
+
+// как соединяются края поля
+enum class topology_t : int {
+    BOUNDED = 0,
+    // левый край с правым, верхний с нижним
+    TORUS,
+    // только левый край с правым
+    CYLINDER
+};
+
+constexpr bool wrapsX(topology_t topology) noexcept
+{ return topology != topology_t::BOUNDED; }
+
+constexpr bool wrapsY(topology_t topology) noexcept
+{ return topology == topology_t::TORUS; }
+
+// координата на поле после обёртки, для несоединённого края не меняется
+constexpr int wrap(int idx, int size, bool wraps) noexcept
+{ return wraps ? ((idx % size) + size) % size : idx; }
+
+// сетка (width + 2 * border) x (height + 2 * border) с заполненной
+// внутренней частью: рамка становится копией соединённых краёв,
+// у несоединённых краёв - пустой. обновляется раз за поколение,
+// чтобы ядро шага читало соседей без проверок края
+template <class T>
+void fillGhostBorder(T* grid, int width, int height, int border,
+                     topology_t topology, T empty = T()) 
+{
+    if (!border || !width || !height) return;
+    std::size_t stride = width + 2 * border;
+    bool wx = wrapsX(topology);
+    for (int y = 0; y < height; ++y) {
+        T* row = grid + (y + border) * stride;
+        for (int i = 0; i < border; ++i) {
+            row[i] = wx ? row[border + wrap(i - border, width, true)] : empty;
+            row[border + width + i] = 
+                wx ? row[border + wrap(i, width, true)] : empty;
+        }
+    }
+    // строки рамки копируются целиком вместе с углами
+    bool wy = wrapsY(topology);
+    for (int i = 0; i < border; ++i) {
+        T* top = grid + i * stride;
+        T* bottom = grid + (border + height + i) * stride;
+        if (wy) {
+            std::copy_n(grid + (border + wrap(i - border, height, true)) 
+                        * stride, stride, top);
+            std::copy_n(grid + (border + wrap(i, height, true)) 
+                        * stride, stride, bottom);
+        } else {
+            std::fill_n(top, stride, empty);
+            std::fill_n(bottom, stride, empty);
+        }
+    }
+}
+
+} // namespace topology
+
+#endif // TOPOLOGY_HPP
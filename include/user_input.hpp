@@ -8,13 +8,14 @@
 
 #include <SFML/Window.hpp>
 
-#include "subject.hpp"
+#include "game_event.hpp"
 
 namespace user_input {
 
-struct IUserInput : subject::ISubject {
+struct IUserInput {
     virtual void readInput() = 0;
     virtual std::tuple<bool, int, int> lastCoordInput() noexcept = 0;
+    virtual game_event::InputBus& events() noexcept = 0;
     
     virtual ~IUserInput() = default;
 };
@@ -35,13 +36,7 @@ public:
 public:
     void readInput() override;
     std::tuple<bool, int, int> lastCoordInput() noexcept override;
-
-public:
-    void attach(std::shared_ptr<observer::IObserver> obs, int event_t) override;
-    void detach(std::weak_ptr<observer::IObserver> obs, int event_t) override;
-
-private:
-    void notify(int event_t) override;
+    game_event::InputBus& events() noexcept override;
 
 private:
     void fireUserAskedClose_(); 
@@ -50,6 +45,7 @@ private:
     void computeCoord_(int x, int y);
 
 private:
+    game_event::InputBus events_;
     std::shared_ptr<sf::Window> window_;    
     float startX_;                          
     float startY_;                          
@@ -0,0 +1,97 @@
+#include "active_tiles.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr int wordBits = 64;
+
+} // namespace
+
+namespace active_tiles {
+
+ActiveTiles::ActiveTiles(
+    int width, int height, topology::topology_t topology) :
+    tilesX_((width + tileSize - 1) / tileSize)
+    , tilesY_((height + tileSize - 1) / tileSize)
+    , topology_(topology)
+{
+    std::size_t words = 
+        (static_cast<std::size_t>(tilesX_) * tilesY_ + wordBits - 1) 
+        / wordBits;
+    changed_.assign(words, 0);
+    active_.assign(words, 0);
+    pinned_.assign(words, 0);
+    markAllChanged();
+}
+
+void ActiveTiles::markChanged(int xidx, int yidx) noexcept
+{ set_(changed_, index_(xidx / tileSize, yidx / tileSize)); }
+
+void ActiveTiles::markAllChanged() noexcept {
+    std::fill(changed_.begin(), changed_.end(), ~std::uint64_t(0));
+}
+
+void ActiveTiles::pin(int xidx, int yidx) noexcept
+{ set_(pinned_, index_(xidx / tileSize, yidx / tileSize)); }
+
+void ActiveTiles::activate() {
+    active_ = pinned_;
+    bool wrapsX = topology::wrapsX(topology_);
+    bool wrapsY = topology::wrapsY(topology_);
+    std::size_t count = static_cast<std::size_t>(tilesX_) * tilesY_;
+    for (std::size_t w = 0; w < changed_.size(); ++w) {
+        auto bits = changed_[w];
+        while (bits) {
+            std::size_t idx = w * wordBits + std::countr_zero(bits);
+            bits &= bits - 1;
+            if (idx >= count) break;
+            int tx = idx % tilesX_;
+            int ty = idx / tilesX_;
+            // изменение плитки затрагивает соседние плитки
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = topology::wrap(tx + dx, tilesX_, wrapsX);
+                    int ny = topology::wrap(ty + dy, tilesY_, wrapsY);
+                    if (nx < 0 || nx >= tilesX_ ||
+                        ny < 0 || ny >= tilesY_) 
+                    {
+                        continue;
+                    }
+                    set_(active_, index_(nx, ny));
+                }
+            }
+        }
+    }
+    std::fill(changed_.begin(), changed_.end(), 0);
+}
+
+bool ActiveTiles::isActive(int tileX, int tileY) const noexcept
+{ return test_(active_, index_(tileX, tileY)); }
+
+int ActiveTiles::activeCount() const noexcept {
+    int res = 0;
+    for (auto w : active_) {
+        res += std::popcount(w);
+    }
+    return res;
+}
+
+int ActiveTiles::tilesX() const noexcept
+{ return tilesX_; }
+
+int ActiveTiles::tilesY() const noexcept
+{ return tilesY_; }
+
+std::size_t ActiveTiles::index_(int tileX, int tileY) const noexcept
+{ return static_cast<std::size_t>(tileY) * tilesX_ + tileX; }
+
+bool ActiveTiles::test_(
+    const std::vector<std::uint64_t>& bits, std::size_t idx) noexcept
+{ return (bits[idx / wordBits] >> (idx % wordBits)) & 1; }
+
+void ActiveTiles::set_(
+    std::vector<std::uint64_t>& bits, std::size_t idx) noexcept
+{ bits[idx / wordBits] |= std::uint64_t(1) << (idx % wordBits); }
+
+} // namespace active_tiles
@@ -0,0 +1,249 @@
+#include "bitboard_engine.hpp"
+
+#include <bit>
+
+namespace {
+    using word_t = std::uint64_t;
+    using counter_t = std::array<word_t, 4>;
+
+    constexpr int wordBits = 64;
+
+    // прибавить к разложенному по битам счётчику по единице в клетках b
+    void addToCounter(counter_t& sum, word_t b) {
+        word_t carry = sum[0] & b;
+        sum[0] ^= b;
+        b = carry;
+        carry = sum[1] & b;
+        sum[1] ^= b;
+        b = carry;
+        carry = sum[2] & b;
+        sum[2] ^= b;
+        sum[3] |= carry;
+    }
+
+    // клетки, в которых счётчик равен n
+    word_t counterEquals(const counter_t& sum, int n) {
+        word_t res = ~word_t(0);
+        for (int i = 0; i < 4; ++i) {
+            res &= ((n >> i) & 1) ? sum[i] : ~sum[i];
+        }
+        return res;
+    }
+
+    int counterAt(const counter_t& sum, int bit) {
+        int res = 0;
+        for (int i = 0; i < 4; ++i) {
+            res |= static_cast<int>((sum[i] >> bit) & 1) << i;
+        }
+        return res;
+    }
+
+} // namespace
+
+namespace game_engine {
+
+BitboardGameEngine::BitboardGameEngine(
+    std::shared_ptr<GameFieldWithFigure> field) :
+    GridGameEngine(field)
+{}
+
+void BitboardGameEngine::loadPlanes_(const FlatCellStorage& storage) {
+    width_ = storage.width();
+    height_ = storage.height();
+    wordsPerRow_ = (width_ + wordBits - 1) / wordBits;
+    // слово рамки слева и справа, строка рамки сверху и снизу
+    stride_ = wordsPerRow_ + 2;
+    int tail = width_ % wordBits;
+    lastWordMask_ = tail ? (word_t(1) << tail) - 1 : ~word_t(0);
+
+    std::size_t sz = static_cast<std::size_t>(stride_) * (height_ + 2);
+    planes_[0].assign(sz, 0);
+    hasPlane_.fill(false);
+    // нулевая плоскость - все существа, она уже собрана
+    hasPlane_[cell_storage::emptyOwner] = true;
+    presentOwners_.clear();
+
+    auto&& owners = storage.owners();
+    for (int y = 0; y < height_; ++y) {
+        const owner_t* src = owners.data()
+                             + static_cast<std::size_t>(y) * width_;
+        for (int x = 0; x < width_; ++x) {
+            owner_t own = src[x];
+            if (own == cell_storage::emptyOwner) continue;
+            if (!hasPlane_[own]) {
+                addOwnerPlane_(own);
+            }
+            word_t bit = word_t(1) << (x % wordBits);
+            std::size_t widx = wordIndex_(y, x / wordBits);
+            planes_[0][widx] |= bit;
+            planes_[own][widx] |= bit;
+        }
+    }
+    fillGhostBorder_(planes_[0]);
+    for (auto own : presentOwners_) {
+        fillGhostBorder_(planes_[own]);
+    }
+    planesLoaded_ = true;
+    planesVersion_ = field_->version();
+}
+
+void BitboardGameEngine::addOwnerPlane_(owner_t own) {
+    planes_[own].assign(planes_[0].size(), 0);
+    hasPlane_[own] = true;
+    presentOwners_.push_back(own);
+}
+
+void BitboardGameEngine::fillGhostBorder_(std::vector<word_t>& plane) const {
+    auto topology = field_->topology();
+    if (topology::wrapsX(topology)) {
+        int tail = width_ % wordBits;
+        int last = (width_ - 1) % wordBits;
+        for (int y = 0; y < height_; ++y) {
+            word_t* row = plane.data() + wordIndex_(y, 0);
+            // сосед слева клетки 0 - последняя клетка строки:
+            // старший бит слова рамки слева
+            row[-1] = ((row[wordsPerRow_ - 1] >> last) & 1) 
+                      << (wordBits - 1);
+            // сосед справа последней клетки - клетка 0: 
+            // бит сразу за последней клеткой
+            word_t first = row[0] & 1;
+            if (tail) {
+                // плоскость живёт между поколениями: старый бит рамки
+                // нужно стереть
+                row[wordsPerRow_ - 1] = 
+                    (row[wordsPerRow_ - 1] & lastWordMask_) | first << tail;
+            } else {
+                row[wordsPerRow_] = first;
+            }
+        }
+    }
+    if (topology::wrapsY(topology)) {
+        std::copy_n(plane.data() + wordIndex_(height_ - 1, -1), stride_,
+                    plane.data() + wordIndex_(-1, -1));
+        std::copy_n(plane.data() + wordIndex_(0, -1), stride_,
+                    plane.data() + wordIndex_(height_, -1));
+    }
+}
+
+std::size_t BitboardGameEngine::wordIndex_(int yidx, int widx) const noexcept
+{ return static_cast<std::size_t>(yidx + 1) * stride_ + widx + 1; }
+
+BitboardGameEngine::counter_t
+BitboardGameEngine::countNeighbors_(
+    const std::vector<word_t>& plane, int yidx, int widx) const
+{
+    // рамка заполнена по топологии поля, проверок края нет
+    const word_t* rows[3] = {
+        plane.data() + wordIndex_(yidx - 1, widx),
+        plane.data() + wordIndex_(yidx, widx),
+        plane.data() + wordIndex_(yidx + 1, widx)
+    };
+    counter_t sum{};
+    for (int k = 0; k < 3; ++k) {
+        const word_t* r = rows[k];
+        // сосед слева: в бит x попадает клетка x - 1
+        word_t west = (r[0] << 1) | (r[-1] >> (wordBits - 1));
+        // сосед справа: в бит x попадает клетка x + 1
+        word_t east = (r[0] >> 1) | (r[1] << (wordBits - 1));
+        addToCounter(sum, west);
+        addToCounter(sum, east);
+        if (k != 1) {
+            addToCounter(sum, r[0]);
+        }
+    }
+    return sum;
+}
+
+void BitboardGameEngine::computeChanges_(const FlatCellStorage& storage) {
+    // поле менялось не через движок: собрать плоскости заново
+    if (!planesLoaded_ || planesVersion_ != field_->version() ||
+        width_ != storage.width() || height_ != storage.height())
+    {
+        loadPlanes_(storage);
+    }
+    changes_.clear();
+    auto&& all = planes_[0];
+    for (int y = 0; y < height_; ++y) {
+        for (int i = 0; i < wordsPerRow_; ++i) {
+            // в последнем слове за клетками может лежать бит рамки
+            word_t mask = i + 1 == wordsPerRow_ ? lastWordMask_ : ~word_t(0);
+            word_t alive = all[wordIndex_(y, i)] & mask;
+            auto sum = countNeighbors_(all, y, i);
+            word_t next = 0;
+            // у соседей Мура не больше 8 соседей
+            for (int n = 0; n <= 8; ++n) {
+                word_t cond = (rule_.survive(n) ? alive : 0)
+                              | (rule_.birth(n) ? ~alive : 0);
+                if (cond) next |= counterEquals(sum, n) & cond;
+            }
+            next &= mask;
+            word_t changed = next ^ alive;
+            if (!changed) continue;
+
+            // рождения и гибели разбираются отдельными проходами, 
+            // изменения слова записываются по порядку клеток
+            std::array<owner_t, wordBits> nextOwner;
+            word_t deaths = changed & ~next;
+            while (deaths) {
+                int bit = std::countr_zero(deaths);
+                deaths &= deaths - 1;
+                nextOwner[bit] = cell_storage::emptyOwner;
+            }
+            // для рождений нужны счётчики соседей каждого игрока
+            word_t births = changed & next;
+            if (births) {
+                std::array<counter_t, cell_storage::maxPlayers + 1> ownerSum;
+                for (auto own : presentOwners_) {
+                    ownerSum[own] = countNeighbors_(planes_[own], y, i);
+                }
+                while (births) {
+                    int bit = std::countr_zero(births);
+                    births &= births - 1;
+                    owner_counts_t count{};
+                    for (auto own : presentOwners_) {
+                        count[own] = counterAt(ownerSum[own], bit);
+                    }
+                    auto own = chooseOwner_(count, i * wordBits + bit, y);
+                    // без соседей-игроков клетка не рождается
+                    if (own == cell_storage::emptyOwner) {
+                        changed &= ~(word_t(1) << bit);
+                    }
+                    nextOwner[bit] = own;
+                }
+            }
+            while (changed) {
+                int bit = std::countr_zero(changed);
+                changed &= changed - 1;
+                changes_.emplace_back(i * wordBits + bit, y, nextOwner[bit]);
+            }
+        }
+    }
+}
+
+void BitboardGameEngine::changesApplied_(const FlatCellStorage& storage) {
+    // клетка берётся из поля: зона могла не применить изменение
+    auto&& owners = storage.owners();
+    for (auto [x, y, next] : changes_) {
+        owner_t own = owners[static_cast<std::size_t>(y) * width_ + x];
+        if (!hasPlane_[own]) {
+            addOwnerPlane_(own);
+        }
+        // рождения и гибели чередуются непредсказуемо:
+        // бит стирается и ставится без ветвлений
+        word_t bit = word_t(1) << (x % wordBits);
+        word_t set = own != cell_storage::emptyOwner ? bit : 0;
+        std::size_t widx = wordIndex_(y, x / wordBits);
+        for (auto prev : presentOwners_) {
+            planes_[prev][widx] &= ~bit;
+        }
+        planes_[0][widx] = (planes_[0][widx] & ~bit) | set;
+        planes_[own][widx] |= set;
+    }
+    fillGhostBorder_(planes_[0]);
+    for (auto own : presentOwners_) {
+        fillGhostBorder_(planes_[own]);
+    }
+    planesVersion_ = field_->version();
+}
+
+} // namespace game_engine
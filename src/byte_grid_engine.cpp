@@ -0,0 +1,103 @@
+#include "byte_grid_engine.hpp"
+
+#include <algorithm>
+
+#include "neighbor_kernel.hpp"
+
+namespace game_engine {
+
+ByteGridGameEngine::ByteGridGameEngine(
+    std::shared_ptr<GameFieldWithFigure> field) :
+    GridGameEngine(field)
+{}
+
+void ByteGridGameEngine::computeChanges_(const FlatCellStorage& storage) {
+    loadGrid_(storage);
+    changes_.clear();
+
+    // таблица правила: rule[alive * 9 + n]
+    std::array<std::uint8_t, 18> rule;
+    for (int n = 0; n < 9; ++n) {
+        rule[n] = rule_.birth(n);
+        rule[9 + n] = rule_.survive(n);
+    }
+
+    auto&& sum = sums_[0];
+    for (int y = 0; y < height_; ++y) {
+        sumRow_(planes_[0], y, sum);
+        const owner_t* row = grid_.data() + (y + 1) * stride_ + 1;
+        bool ownerSumsReady = false;
+        for (int x = 0; x < width_; ++x) {
+            int alive = row[x] != cell_storage::emptyOwner;
+            if (rule[alive * 9 + sum[x]] == alive) continue;
+            if (alive) {
+                changes_.emplace_back(x, y, cell_storage::emptyOwner);
+                continue;
+            }
+            // для рождения нужны суммы соседей каждого игрока
+            if (!ownerSumsReady) {
+                for (auto own : presentOwners_) {
+                    sumRow_(planes_[own], y, sums_[own]);
+                }
+                ownerSumsReady = true;
+            }
+            owner_counts_t count{};
+            for (auto own : presentOwners_) {
+                count[own] = sums_[own][x];
+            }
+            auto own = chooseOwner_(count, x, y);
+            if (own != cell_storage::emptyOwner) {
+                changes_.emplace_back(x, y, own);
+            }
+        }
+    }
+}
+
+void ByteGridGameEngine::loadGrid_(const FlatCellStorage& storage) {
+    width_ = storage.width();
+    height_ = storage.height();
+    stride_ = width_ + 2;
+    std::size_t sz = static_cast<std::size_t>(stride_) * (height_ + 2);
+    grid_.assign(sz, cell_storage::emptyOwner);
+
+    auto&& owners = storage.owners();
+    std::array<bool, cell_storage::maxPlayers + 1> present{};
+    presentOwners_.clear();
+    for (int y = 0; y < height_; ++y) {
+        const owner_t* src = owners.data() 
+                             + static_cast<std::size_t>(y) * width_;
+        owner_t* dst = grid_.data() + (y + 1) * stride_ + 1;
+        std::copy(src, src + width_, dst);
+        for (int x = 0; x < width_; ++x) {
+            if (src[x] != cell_storage::emptyOwner && !present[src[x]]) {
+                present[src[x]] = true;
+                presentOwners_.push_back(src[x]);
+            }
+        }
+    }
+    topology::fillGhostBorder(grid_.data(), width_, height_, 1, 
+        field_->topology(), cell_storage::emptyOwner);
+
+    planes_[0].resize(sz);
+    std::transform(grid_.begin(), grid_.end(), planes_[0].begin(),
+        [] (owner_t own) -> std::uint8_t { return own != 0; });
+    for (auto own : presentOwners_) {
+        planes_[own].resize(sz);
+        std::transform(grid_.begin(), grid_.end(), planes_[own].begin(),
+            [own] (owner_t o) -> std::uint8_t { return o == own; });
+    }
+    for (auto&& s : sums_) {
+        s.resize(width_);
+    }
+}
+
+void ByteGridGameEngine::sumRow_(
+    const std::vector<std::uint8_t>& plane, 
+    int yidx, std::vector<std::uint8_t>& out) const
+{
+    const std::uint8_t* row = plane.data() + (yidx + 1) * stride_ + 1;
+    neighbor_kernel::sumRowNeighbors(
+        row - stride_, row, row + stride_, out.data(), width_);
+}
+
+} // namespace game_engine
@@ -0,0 +1,393 @@
+#include "cell_storage.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    using cell_storage::owner_t;
+    using cell_storage::row_change_t;
+
+    // сравнить строку текущего и прошлого буфера: равные
+    // отрезки по 8 клеток пропускаются одним сравнением
+    void diffRows(const owner_t* cur, const owner_t* prev,
+        int xbegin, int xend, std::vector<row_change_t>& diff)
+    {
+        int x = xbegin;
+        while (x < xend) {
+            if (x + 8 <= xend && !std::memcmp(cur + x, prev + x, 8)) {
+                x += 8;
+                continue;
+            }
+            if (cur[x] != prev[x]) {
+                diff.emplace_back(x, prev[x], cur[x]);
+            }
+            ++x;
+        }
+    }
+
+} // namespace
+
+namespace cell_storage {
+
+CellObjectStorage::CellObjectStorage(
+    std::unique_ptr<factory::ICellFactory> cellFactory) :
+    cellFactory_(std::move(cellFactory))
+{}
+
+void CellObjectStorage::reset(int width, int height) {
+    if (width == this->width() && height == this->height()) {
+        // очистка поля: клетки-объекты переиспользуются без выделений
+        for (auto&& r : field_) {
+            for (auto&& c : r) {
+                c->removeCreature();
+            }
+        }
+        std::fill(next_.begin(), next_.end(), emptyOwner);
+        return;
+    }
+    field_ = decltype(field_)();
+    field_.reserve(height);
+    for (int i = 0; i < height; ++i) {
+        std::vector<std::unique_ptr<cell::ICell>> r;
+        r.reserve(width);
+        for (int j = 0; j < width; ++j) {
+            r.emplace_back(cellFactory_->createCell());
+        }
+        field_.emplace_back(std::move(r));
+    }
+    next_.assign(static_cast<std::size_t>(width) * height, emptyOwner);
+}
+
+owner_t CellObjectStorage::owner(int xidx, int yidx) const
+{ return field_.at(yidx).at(xidx)->owner(); }
+
+void CellObjectStorage::setOwner(int xidx, int yidx, owner_t owner)
+{ field_.at(yidx).at(xidx)->setOwner(owner); }
+
+bool CellObjectStorage::hasCreature(int xidx, int yidx) const
+{ return field_.at(yidx).at(xidx)->hasCreature(); }
+
+void CellObjectStorage::removeCreature(int xidx, int yidx)
+{ field_.at(yidx).at(xidx)->removeCreature(); }
+
+void CellObjectStorage::setNeighborTable(
+    std::shared_ptr<const neighbor_table::NeighborTable> table)
+{ neighbors_ = table; }
+
+void CellObjectStorage::countNeighborsCreatures(
+    int xidx, int yidx, neighbor_counts_t& count) const
+{
+    verifyThenThrowCellPos_(xidx, yidx);
+    count.fill(0);
+    int w = width();
+    for (auto ne : neighbors_->neighbors(neighbors_->index(xidx, yidx))) {
+        auto own = field_[ne / w][ne % w]->owner();
+        if (own != emptyOwner) {
+            ++count[own - 1];
+        }
+    }
+}
+
+int CellObjectStorage::width() const noexcept
+{ return field_.empty() ? 0 : field_.back().size(); }
+
+int CellObjectStorage::height() const noexcept
+{ return field_.size(); }
+
+void CellObjectStorage::beginGeneration() {
+    auto it = next_.begin();
+    for (auto&& r : field_) {
+        for (auto&& c : r) {
+            *it++ = c->owner();
+        }
+    }
+}
+
+void CellObjectStorage::setNextOwner(
+    int xidx, int yidx, owner_t owner) noexcept
+{ next_[static_cast<std::size_t>(yidx) * width() + xidx] = owner; }
+
+void CellObjectStorage::swapGeneration() noexcept {
+    // клетки - отдельные объекты, поэтому обмен поклеточный: O(клеток)
+    auto it = next_.begin();
+    for (auto&& r : field_) {
+        for (auto&& c : r) {
+            auto own = c->owner();
+            c->setOwner(*it);
+            *it++ = own;
+        }
+    }
+}
+
+owner_t CellObjectStorage::previousOwner(int xidx, int yidx) const {
+    verifyThenThrowCellPos_(xidx, yidx);
+    return next_[static_cast<std::size_t>(yidx) * width() + xidx];
+}
+
+void CellObjectStorage::diffGeneration(int yidx, int xbegin, int xend,
+    std::vector<row_change_t>& diff) const
+{
+    auto&& row = field_[yidx];
+    const owner_t* prev = next_.data() 
+                          + static_cast<std::size_t>(yidx) * width();
+    for (int x = xbegin; x < xend; ++x) {
+        auto own = row[x]->owner();
+        if (own != prev[x]) {
+            diff.emplace_back(x, prev[x], own);
+        }
+    }
+}
+
+void CellObjectStorage::readSpan(int yidx, int xbegin,
+    std::span<owner_t> owners, std::span<neighbor_counts_t> counts) const
+{
+    auto&& row = field_[yidx];
+    int w = width();
+    for (std::size_t i = 0; i < owners.size(); ++i) {
+        auto idx = static_cast<std::size_t>(yidx) * w + xbegin + i;
+        owners[i] = row[xbegin + i]->owner();
+        counts[i].fill(0);
+        for (auto ne : neighbors_->neighbors(idx)) {
+            auto own = field_[ne / w][ne % w]->owner();
+            if (own != emptyOwner) {
+                ++counts[i][own - 1];
+            }
+        }
+    }
+}
+
+void CellObjectStorage::verifyThenThrowCellPos_(int xidx, int yidx) const {
+    if (xidx < 0 || xidx >= width() ||
+        yidx < 0 || yidx >= height())
+    {
+        throw std::out_of_range("Cell position is out of range.");
+    }
+}
+
+void FlatCellStorage::reset(int width, int height) {
+    width_ = width;
+    height_ = height;
+    std::size_t sz = static_cast<std::size_t>(width) * height;
+    cells_.assign(sz, emptyOwner);
+    next_.assign(sz, emptyOwner);
+}
+
+owner_t FlatCellStorage::owner(int xidx, int yidx) const
+{ return cells_[index_(xidx, yidx)]; }
+
+void FlatCellStorage::setOwner(int xidx, int yidx, owner_t owner)
+{ cells_[index_(xidx, yidx)] = owner; }
+
+bool FlatCellStorage::hasCreature(int xidx, int yidx) const
+{ return cells_[index_(xidx, yidx)] != emptyOwner; }
+
+void FlatCellStorage::removeCreature(int xidx, int yidx)
+{ cells_[index_(xidx, yidx)] = emptyOwner; }
+
+void FlatCellStorage::setNeighborTable(
+    std::shared_ptr<const neighbor_table::NeighborTable> table)
+{ neighbors_ = table; }
+
+void FlatCellStorage::countNeighborsCreatures(
+    int xidx, int yidx, neighbor_counts_t& count) const
+{
+    auto idx = index_(xidx, yidx);
+    // нулевой элемент считает пустых соседей
+    std::array<int, maxPlayers + 1> ownCount{};
+    for (auto ne : neighbors_->neighbors(idx)) {
+        ++ownCount[cells_[ne]];
+    }
+    std::copy(ownCount.begin() + 1, ownCount.end(), count.begin());
+}
+
+int FlatCellStorage::width() const noexcept
+{ return width_; }
+
+int FlatCellStorage::height() const noexcept
+{ return height_; }
+
+void FlatCellStorage::beginGeneration()
+{ std::copy(cells_.begin(), cells_.end(), next_.begin()); }
+
+void FlatCellStorage::setNextOwner(
+    int xidx, int yidx, owner_t owner) noexcept
+{ next_[static_cast<std::size_t>(yidx) * width_ + xidx] = owner; }
+
+void FlatCellStorage::swapGeneration() noexcept
+{ cells_.swap(next_); }
+
+owner_t FlatCellStorage::previousOwner(int xidx, int yidx) const
+{ return next_[index_(xidx, yidx)]; }
+
+void FlatCellStorage::diffGeneration(int yidx, int xbegin, int xend,
+    std::vector<row_change_t>& diff) const
+{
+    auto offset = static_cast<std::size_t>(yidx) * width_;
+    diffRows(cells_.data() + offset, next_.data() + offset, 
+             xbegin, xend, diff);
+}
+
+void FlatCellStorage::readSpan(int yidx, int xbegin,
+    std::span<owner_t> owners, std::span<neighbor_counts_t> counts) const
+{
+    auto idx = static_cast<std::size_t>(yidx) * width_ + xbegin;
+    auto&& offsets = neighbors_->offsets();
+    auto&& indices = neighbors_->indices();
+    for (std::size_t i = 0; i < owners.size(); ++i, ++idx) {
+        owners[i] = cells_[idx];
+        // нулевой элемент считает пустых соседей
+        std::array<int, maxPlayers + 1> ownCount{};
+        for (auto k = offsets[idx]; k < offsets[idx + 1]; ++k) {
+            ++ownCount[cells_[indices[k]]];
+        }
+        std::copy(ownCount.begin() + 1, ownCount.end(), counts[i].begin());
+    }
+}
+
+const std::vector<owner_t>& FlatCellStorage::owners() const noexcept
+{ return cells_; }
+
+std::size_t FlatCellStorage::index_(int xidx, int yidx) const {
+    if (xidx < 0 || xidx >= width_ ||
+        yidx < 0 || yidx >= height_)
+    {
+        throw std::out_of_range("Cell position is out of range.");
+    }
+    return static_cast<std::size_t>(yidx) * width_ + xidx;
+}
+
+void CountingCellStorage::reset(int width, int height) {
+    width_ = width;
+    height_ = height;
+    std::size_t sz = static_cast<std::size_t>(width) * height;
+    cells_.assign(sz, emptyOwner);
+    next_.assign(sz, emptyOwner);
+    counts_.assign(sz * maxPlayers, 0);
+    pending_.clear();
+    pending_.reserve(sz);
+    isPending_.assign(sz, false);
+}
+
+owner_t CountingCellStorage::owner(int xidx, int yidx) const
+{ return cells_[index_(xidx, yidx)]; }
+
+void CountingCellStorage::setOwner(int xidx, int yidx, owner_t owner) {
+    auto idx = index_(xidx, yidx);
+    auto prev = cells_[idx];
+    if (prev == owner) return;
+    cells_[idx] = owner;
+    moveOwner_(idx, prev, owner);
+}
+
+bool CountingCellStorage::hasCreature(int xidx, int yidx) const
+{ return cells_[index_(xidx, yidx)] != emptyOwner; }
+
+void CountingCellStorage::removeCreature(int xidx, int yidx)
+{ setOwner(xidx, yidx, emptyOwner); }
+
+void CountingCellStorage::setNeighborTable(
+    std::shared_ptr<const neighbor_table::NeighborTable> table)
+{
+    neighbors_ = table;
+    dependents_ = std::make_shared<const neighbor_table::NeighborTable>(
+        table->transposed());
+    // у связанных клеток могли появиться соседи
+    recount_();
+}
+
+void CountingCellStorage::countNeighborsCreatures(
+    int xidx, int yidx, neighbor_counts_t& count) const
+{
+    auto it = counts_.begin() + index_(xidx, yidx) * maxPlayers;
+    std::copy(it, it + maxPlayers, count.begin());
+}
+
+int CountingCellStorage::width() const noexcept
+{ return width_; }
+
+int CountingCellStorage::height() const noexcept
+{ return height_; }
+
+void CountingCellStorage::beginGeneration()
+{ std::copy(cells_.begin(), cells_.end(), next_.begin()); }
+
+void CountingCellStorage::setNextOwner(
+    int xidx, int yidx, owner_t owner) noexcept
+{
+    auto idx = static_cast<std::size_t>(yidx) * width_ + xidx;
+    if (!isPending_[idx]) {
+        isPending_[idx] = true;
+        // ёмкость выделена при сбросе, вставка не выделяет память
+        pending_.push_back(static_cast<std::uint32_t>(idx));
+    }
+    next_[idx] = owner;
+}
+
+void CountingCellStorage::swapGeneration() noexcept {
+    cells_.swap(next_);
+    // обновить счётчики только вокруг изменившихся клеток
+    for (auto idx : pending_) {
+        isPending_[idx] = false;
+        if (next_[idx] != cells_[idx]) {
+            moveOwner_(idx, next_[idx], cells_[idx]);
+        }
+    }
+    pending_.clear();
+}
+
+owner_t CountingCellStorage::previousOwner(int xidx, int yidx) const
+{ return next_[index_(xidx, yidx)]; }
+
+void CountingCellStorage::diffGeneration(int yidx, int xbegin, int xend,
+    std::vector<row_change_t>& diff) const
+{
+    auto offset = static_cast<std::size_t>(yidx) * width_;
+    diffRows(cells_.data() + offset, next_.data() + offset, 
+             xbegin, xend, diff);
+}
+
+void CountingCellStorage::readSpan(int yidx, int xbegin,
+    std::span<owner_t> owners, std::span<neighbor_counts_t> counts) const
+{
+    auto idx = static_cast<std::size_t>(yidx) * width_ + xbegin;
+    std::copy_n(cells_.begin() + idx, owners.size(), owners.begin());
+    auto it = counts_.begin() + idx * maxPlayers;
+    for (std::size_t i = 0; i < owners.size(); ++i, it += maxPlayers) {
+        std::copy(it, it + maxPlayers, counts[i].begin());
+    }
+}
+
+const std::vector<owner_t>& CountingCellStorage::owners() const noexcept
+{ return cells_; }
+
+std::size_t CountingCellStorage::index_(int xidx, int yidx) const {
+    if (xidx < 0 || xidx >= width_ ||
+        yidx < 0 || yidx >= height_)
+    {
+        throw std::out_of_range("Cell position is out of range.");
+    }
+    return static_cast<std::size_t>(yidx) * width_ + xidx;
+}
+
+void CountingCellStorage::moveOwner_(
+    std::size_t cell, owner_t from, owner_t to) noexcept
+{
+    if (!dependents_) return;
+    for (auto dep : dependents_->neighbors(cell)) {
+        auto* count = counts_.data() + std::size_t(dep) * maxPlayers;
+        if (from != emptyOwner) --count[from - 1];
+        if (to != emptyOwner) ++count[to - 1];
+    }
+}
+
+void CountingCellStorage::recount_() noexcept {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+        if (cells_[idx] != emptyOwner) {
+            moveOwner_(idx, emptyOwner, cells_[idx]);
+        }
+    }
+}
+
+} // namespace cell_storage
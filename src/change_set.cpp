@@ -0,0 +1,76 @@
+#include "change_set.hpp"
+
+namespace change_set {
+
+ChangeSet::ChangeSet(int width, std::uint64_t sequence) :
+    width_(width)
+    , sequence_(sequence)
+{}
+
+void ChangeSet::add(int xidx, int yidx, owner_t owner) {
+    cells_.push_back(static_cast<std::uint32_t>(yidx) * width_ + xidx);
+    owners_.push_back(owner);
+}
+
+void ChangeSet::reset(int width, std::uint64_t sequence) noexcept {
+    width_ = width;
+    sequence_ = sequence;
+    cells_.clear();
+    owners_.clear();
+}
+
+std::size_t ChangeSet::size() const noexcept
+{ return cells_.size(); }
+
+bool ChangeSet::empty() const noexcept
+{ return cells_.empty(); }
+
+std::uint32_t ChangeSet::cell(std::size_t i) const noexcept
+{ return cells_[i]; }
+
+cell_storage::owner_t ChangeSet::owner(std::size_t i) const noexcept
+{ return owners_[i]; }
+
+std::pair<int, int> ChangeSet::position(std::size_t i) const noexcept {
+    return { static_cast<int>(cells_[i] % width_),
+             static_cast<int>(cells_[i] / width_) };
+}
+
+int ChangeSet::width() const noexcept
+{ return width_; }
+
+std::uint64_t ChangeSet::sequence() const noexcept
+{ return sequence_; }
+
+std::shared_ptr<ChangeSet> 
+ChangeSetPool::acquire(int width, std::uint64_t sequence) {
+    // свободных наборов хватает, если обработчики не копят их
+    constexpr std::size_t maxFreeSets = 4;
+    std::unique_ptr<ChangeSet> set;
+    {
+        std::lock_guard lk(free_->mutex);
+        if (!free_->sets.empty()) {
+            set = std::move(free_->sets.back());
+            free_->sets.pop_back();
+        }
+    }
+    if (set) {
+        set->reset(width, sequence);
+    } else {
+        set = std::make_unique<ChangeSet>(width, sequence);
+    }
+    return std::shared_ptr<ChangeSet>(set.release(), 
+        [freeList = free_] (ChangeSet* released) noexcept {
+            std::unique_ptr<ChangeSet> owned(released);
+            std::lock_guard lk(freeList->mutex);
+            if (freeList->sets.size() < maxFreeSets) {
+                try {
+                    freeList->sets.push_back(std::move(owned));
+                } catch (...) {
+                    // не вернулся в список - освобождается
+                }
+            }
+        });
+}
+
+} // namespace change_set
@@ -2,11 +2,41 @@
 
 namespace creature_strategy {
 
-bool ConwayCreatureStrategy::computeLiveStatus(
+TransitionTable TransitionTable::sample(ICreatureStrategy& strategy) {
+    mask_t birth = 0;
+    mask_t survive = 0;
+    for (int n = 0; n <= maxNeighbors; ++n) {
+        birth |= mask_t(strategy.computeLiveStatus(n, false)) << n;
+        survive |= mask_t(strategy.computeLiveStatus(n, true)) << n;
+    }
+    return { birth, survive };
+}
+
+TransitionTable ICreatureStrategy::transitionTable() 
+{ return TransitionTable::sample(*this); }
+
+TableCreatureStrategy::TableCreatureStrategy(const TransitionTable& table) :
+    table_(table)
+{}
+
+bool TableCreatureStrategy::computeLiveStatus(
     int neighborsCount, bool isAlive) 
 {
-    return (neighborsCount == 2 && isAlive) || neighborsCount == 3;
+    if (neighborsCount < 0 || 
+        neighborsCount > TransitionTable::maxNeighbors) 
+    {
+        return false;
+    }
+    return table_.next(isAlive, neighborsCount);
 }
 
+TransitionTable TableCreatureStrategy::transitionTable()
+{ return table_; }
+
+ParsedRuleCreatureStrategy::ParsedRuleCreatureStrategy(
+    std::string_view rule) :
+    TableCreatureStrategy(parseRule(rule))
+{}
+
 
-} // namespace creature_strategy
\ No newline at end of file
+} // namespace creature_strategy
@@ -0,0 +1,113 @@
+#include "field_snapshot.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "change_set.hpp"
+#include "game_field.hpp"
+
+namespace field_snapshot {
+
+FieldSnapshot::FieldSnapshot(int width, int height, std::uint64_t sequence,
+    std::vector<changed_cell_t> cells) :
+    width_(width)
+    , height_(height)
+    , sequence_(sequence)
+    , cells_(std::move(cells))
+{
+    auto sz = static_cast<std::size_t>(width_) * height_;
+    if (cells_.size() > sz) {
+        throw std::logic_error("The snapshot size does not match the field.");
+    }
+}
+
+int FieldSnapshot::width() const noexcept
+{ return width_; }
+
+int FieldSnapshot::height() const noexcept
+{ return height_; }
+
+std::uint64_t FieldSnapshot::sequence() const noexcept
+{ return sequence_; }
+
+const std::vector<changed_cell_t>&
+FieldSnapshot::changedCells() const noexcept
+{ return cells_; }
+
+SnapshotPublisher::SnapshotPublisher(
+    const game_field::GameFieldWithFigure& field) :
+    width_(field.width())
+    , height_(field.height())
+    , owners_(static_cast<std::size_t>(width_) * height_,
+              cell_storage::emptyOwner)
+    , isDirty_(owners_.size(), false)
+{
+    dirty_.reserve(owners_.size());
+    auto&& storage = field.storage();
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            auto cell = static_cast<std::size_t>(y) * width_ + x;
+            owners_[cell] = storage.owner(x, y);
+            // первый снимок рисует поле целиком
+            markDirty_(cell);
+        }
+    }
+}
+
+void SnapshotPublisher::on(const game_event::FieldCleared&) {
+    std::lock_guard lk(mutex_);
+    std::fill(owners_.begin(), owners_.end(), cell_storage::emptyOwner);
+    for (std::size_t cell = 0; cell < owners_.size(); ++cell) {
+        markDirty_(cell);
+    }
+}
+
+void SnapshotPublisher::on(const game_event::CreatureSet& evt) {
+    apply_(*evt.changes);
+}
+
+void SnapshotPublisher::on(const game_event::CreatureRemoved& evt) {
+    apply_(*evt.changes);
+}
+
+void SnapshotPublisher::on(const game_event::ChangesApplied& evt) {
+    apply_(*evt.changes);
+}
+
+std::shared_ptr<const FieldSnapshot> SnapshotPublisher::take() {
+    std::vector<changed_cell_t> cells;
+    {
+        std::lock_guard lk(mutex_);
+        if (dirty_.empty()) {
+            return nullptr;
+        }
+        // копируются только изменившиеся клетки, поток модели
+        // ждёт O(изменений), а не O(клеток)
+        cells.reserve(dirty_.size());
+        for (auto cell : dirty_) {
+            cells.push_back({cell, owners_[cell]});
+            isDirty_[cell] = false;
+        }
+        dirty_.clear();
+    }
+    return std::make_shared<const FieldSnapshot>(
+        width_, height_, sequence_++, std::move(cells));
+}
+
+void SnapshotPublisher::apply_(const change_set::ChangeSet& changes) {
+    std::lock_guard lk(mutex_);
+    for (std::size_t i = 0; i < changes.size(); ++i) {
+        auto cell = changes.cell(i);
+        owners_[cell] = changes.owner(i);
+        markDirty_(cell);
+    }
+}
+
+void SnapshotPublisher::markDirty_(std::size_t cell) {
+    if (!isDirty_[cell]) {
+        isDirty_[cell] = true;
+        dirty_.push_back(static_cast<std::uint32_t>(cell));
+    }
+}
+
+} // namespace field_snapshot
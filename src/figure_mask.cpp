@@ -0,0 +1,56 @@
+#include "figure_mask.hpp"
+
+namespace figure_mask {
+
+FigureMask::FigureMask(int width, int height, figure::IFigure& figure) :
+    width_(width)
+    , height_(height)
+{
+    bits_.assign((static_cast<std::size_t>(width) * height + 63) / 64, 0);
+    rowOffsets_.reserve(height + 1);
+    rowOffsets_.push_back(0);
+    for (int y = 0; y < height; ++y) {
+        int begin = -1;
+        for (int x = 0; x <= width; ++x) {
+            bool inside = x < width && figure.isPointInFigure(x, y);
+            if (inside) {
+                auto idx = static_cast<std::size_t>(y) * width + x;
+                bits_[idx / 64] |= std::uint64_t(1) << (idx % 64);
+                ++cellCount_;
+                if (begin < 0) begin = x;
+            } else if (begin >= 0) {
+                spans_.push_back({ begin, x });
+                begin = -1;
+            }
+        }
+        rowOffsets_.push_back(spans_.size());
+    }
+}
+
+bool FigureMask::contains(int xidx, int yidx) const noexcept {
+    if (xidx < 0 || xidx >= width_ || yidx < 0 || yidx >= height_) {
+        return false;
+    }
+    auto idx = static_cast<std::size_t>(yidx) * width_ + xidx;
+    return (bits_[idx / 64] >> (idx % 64)) & 1;
+}
+
+std::span<const span_t> FigureMask::rowSpans(int yidx) const noexcept {
+    if (yidx < 0 || yidx >= height_) return {};
+    return std::span<const span_t>(spans_).subspan(
+        rowOffsets_[yidx], rowOffsets_[yidx + 1] - rowOffsets_[yidx]);
+}
+
+bool FigureMask::isFull() const noexcept
+{ return cellCount_ == width_ * height_; }
+
+int FigureMask::cellCount() const noexcept
+{ return cellCount_; }
+
+int FigureMask::width() const noexcept
+{ return width_; }
+
+int FigureMask::height() const noexcept
+{ return height_; }
+
+} // namespace figure_mask
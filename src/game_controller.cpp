@@ -1,9 +1,12 @@
 #include "game_controller.hpp"
 
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <exception>
 
 namespace {
-    using IGameField = game_field::IGameField;
     using IGameFieldArea = game_field_area::IGameFieldArea;
     using IGameModel = game_model::IGameModel;
     using IUserInput = user_input::IUserInput;
@@ -12,6 +15,9 @@ namespace {
     using IGameFieldArea = game_field_area::IGameFieldArea;
     using DrawableGridCanvas = view::DrawableGridCanvas;
 
+    // период кадра: ввод читается и поле рисуется не чаще
+    constexpr auto framePeriod = std::chrono::milliseconds(16);
+
 } // namespace
 
 namespace game_controller {
@@ -23,82 +29,89 @@ GameController::GameController(
         std::shared_ptr<IUserInput> input,
         std::shared_ptr<sf::RenderWindow> window,
         const std::unordered_map<int, sf::Color>& playersCreatureColors,
-        const std::shared_ptr<IGameField> field):
+        std::shared_ptr<SnapshotPublisher> snapshots):
     area_(std::move(area))
     , model_(model)
     , view_(view)
     , input_(input)
     , window_(window)
     , playersCreatureColors_(playersCreatureColors)
-    , field_(field)
+    , snapshots_(snapshots)
+    , modelEvents_(std::make_shared<game_event::ModelQueue>())
 { drawCanvasBackground_(); }
 
-void GameController::update(int event_t)
-{   
-    using evt_t = game_event::event_t;
-    auto evt = static_cast<evt_t>(event_t);
-    switch (evt) {
-        case evt_t::FIELD_CLEAR: {
-            clearGridCanvas_();
-            redrawWindowNDisplay_();
-            break;
-        }
-        case evt_t::CREATURE_REMOVE_IN_FIELD: {
-            auto [x, y] = field_->lastAffectedCell();
-            updateCellInGridCanvasInView_(x, y);
-            if (gameModelSetupPhase_) {
-                redrawWindowNDisplay_();
-            }
-            break;
-        }
-        case evt_t::CREATURE_SET_IN_FIELD: {
-            auto [x, y] = field_->lastAffectedCell();
-            updateCellInGridCanvasInView_(x, y);
-            if (gameModelSetupPhase_) {
-                redrawWindowNDisplay_();
-            }
-            break;
-        }
-        case evt_t::PLAYER_BETS_CREATURES: {
-            auto id = model_->curPlayer();
-            auto movesCount = model_->movesRemained();
-            auto p = model_->curPlayer();
-            notifyAboutPlayerParticipation_(p->name(), movesCount);
-            gameModelSetupPhase_ = true;
-            break;
-        }
-        case evt_t::GAME_MODEL_CALCULATED_ER: {
-            auto erRem = model_->erRemained();
-            notifyAboutModelComputing_(erRem);
-            gameModelSetupPhase_ = false;
-            break;
-        }
-        case evt_t::WINNER_DETERMINATE: {
-            auto p = model_->winnerPlayer();
-            notifyAboutWinner_(p->name());
-            break;
-        }
-        case evt_t::DRAW_DETERMINATE: {
-            notifyAboutDraw_();
-            break;
-        }
-        case evt_t::USER_INPUT_REQUIRED: {
-            input_->readInput();
-            break;
-        }
-        case evt_t::USER_ASKED_SET_CREATURE: {
-            auto [suc, x, y] = input_->lastCoordInput();
-            if (suc) {
-                auto p = model_->curPlayer();
-                p->tapOnCreature(x, y);
-            }
+void GameController::on(const game_event::PlayerBetsCreatures& evt) {
+    notifyAboutPlayerParticipation_(evt.player->name(), evt.movesRemained);
+}
+
+void GameController::on(const game_event::ErCalculated& evt) {
+    notifyAboutModelComputing_(evt.erRemained, evt.population);
+}
+
+void GameController::on(const game_event::WinnerDetermined& evt) {
+    notifyAboutWinner_(evt.winner->name());
+}
+
+void GameController::on(const game_event::DrawDetermined&) {
+    notifyAboutDraw_();
+}
+
+void GameController::game() {
+    std::atomic<bool> modelFinished = false;
+    std::exception_ptr modelError;
+    std::thread simulation([&] {
+        try {
+            model_->game();
+        } catch (...) {
+            modelError = std::current_exception();
         }
+        modelFinished = true;
+    });
+    try {
+        runFrames_(modelFinished);
+    } catch (...) {
+        // без закрытия поток модели не завершится
+        model_->inbox()->on(game_event::UserAskedClose{});
+        simulation.join();
+        throw;
+    }
+    simulation.join();
+    if (modelError) {
+        std::rethrow_exception(modelError);
     }
 }
 
-void GameController::game() {
-    model_->game();
-}       
+std::shared_ptr<game_event::ModelQueue> 
+GameController::modelEvents() const noexcept {
+    return modelEvents_;
+}
+
+void GameController::runFrames_(const std::atomic<bool>& modelFinished) {
+    auto nextFrame = std::chrono::steady_clock::now();
+    while (!modelFinished) {
+        // ввод уходит в очередь модели
+        input_->readInput();
+        modelEvents_->dispatch(*this);
+        renderFrame_();
+        // отставший кадр не копит долг: следующий отсчитывается от текущего
+        nextFrame = std::max(nextFrame + framePeriod, 
+                             std::chrono::steady_clock::now());
+        std::this_thread::sleep_until(nextFrame);
+    }
+}
+
+void GameController::renderFrame_() {
+    // снимок забирается раз в кадр и несёт все клетки, изменившиеся
+    // после прошлого кадра, даже если модель считает быстрее кадров
+    if (auto snapshot = snapshots_->take()) {
+        paintSnapshot_(*snapshot);
+        needsRedraw_ = true;
+    }
+    if (needsRedraw_) {
+        redrawWindowNDisplay_();
+        needsRedraw_ = false;
+    }
+}
 
 void GameController::redrawWindowNDisplay_() {
     std::pair<unsigned, unsigned> windowSz = view_->size();
@@ -108,6 +121,14 @@ void GameController::redrawWindowNDisplay_() {
     window_->display();
 }
 
+void GameController::paintSnapshot_(const FieldSnapshot& snapshot) {
+    auto grid = getCanvasComp_();
+    for (auto [cell, owner] : snapshot.changedCells()) {
+        paintCell_(*grid, cell % snapshot.width(), cell / snapshot.width(),
+                   owner);
+    }
+}
+
 std::shared_ptr<DrawableGridCanvas> 
 GameController::getCanvasComp_() 
 {
@@ -126,25 +147,19 @@ GameController::getCanvasComp_()
     }
 }
 
-void GameController::clearGridCanvas_() {
-    getCanvasComp_()->clear();
-    drawCanvasBackground_();
-}
-
-void GameController::updateCellInGridCanvasInView_(int xidx, int yidx) {
-    auto grid = getCanvasComp_();
+void GameController::paintCell_(DrawableGridCanvas& grid, 
+    int xidx, int yidx, cell_storage::owner_t owner) 
+{
     sf::Color color;
     if (!area_->isCellAvailable(xidx, yidx)) {
         color = sf::Color::Black;
+    } else if (owner != cell_storage::emptyOwner) {
+        // id игрока - владелец без единицы
+        color = playersCreatureColors_.at(owner - 1);
     } else {
-        if (area_->hasCreatureInCell(xidx, yidx)) {
-            auto&& cr = area_->getCreatureByCell(xidx, yidx);
-            color = playersCreatureColors_.at(cr.player()->id());
-        } else {
-            color = sf::Color::White;
-        }
+        color = sf::Color::White;
     }
-    grid->paintCell({xidx, yidx}, color);
+    grid.paintCell({xidx, yidx}, color);
 } 
 
 void GameController::notifyAboutWinner_(const std::string& name) {
@@ -170,10 +185,19 @@ void GameController::notifyAboutPlayerParticipation_(
     setTextOnTextComp_(ss.str());
 }
 
-void GameController::notifyAboutModelComputing_(int n) {
+void GameController::notifyAboutModelComputing_(int n,
+    const cell_storage::population_t& population) 
+{
     std::stringstream ss;
     ss << "Remaining er: ";
     ss << n;
+    ss << ". Creatures:";
+    // количество существ каждого игрока приходит с событием
+    for (int id = 0; id < cell_storage::maxPlayers; ++id) {
+        if (playersCreatureColors_.contains(id)) {
+            ss << ' ' << population[id + 1];
+        }
+    }
     ss << '.';
     setTextOnTextComp_(ss.str());
 }
@@ -188,7 +212,8 @@ void GameController::setTextOnTextComp_(const std::string& txt) {
         std::dynamic_pointer_cast<view::DrawableText>(comp))
     {   
         text->setText(txt);
-        redrawWindowNDisplay_();
+        // окно перерисуется в ближайшем кадре
+        needsRedraw_ = true;
     } else {
         throw std::logic_error(
             "The view is missing the DrawableText component");
@@ -198,14 +223,19 @@ void GameController::setTextOnTextComp_(const std::string& txt) {
 void GameController::drawCanvasBackground_() {
     auto grid = getCanvasComp_();
     for (int y = 0; y < area_->height(); ++y) {
-        for (int x = 0; x < area_->width(); ++x) {
-            sf::Color color;
-            if (area_->isCellAvailable(x, y)) {
-                color = sf::Color::White;
-            } else {
-                color = sf::Color::Black;
-            }
-            grid->paintCell({x, y}, color);
+        // доступные клетки - белые, промежутки между отрезками - чёрные
+        int x = 0;
+        area_->forEachAvailableSpan(y, 0, area_->width(), 
+            [&] (int begin, int end) {
+                for (; x < begin; ++x) {
+                    grid->paintCell({x, y}, sf::Color::Black);
+                }
+                for (; x < end; ++x) {
+                    grid->paintCell({x, y}, sf::Color::White);
+                }
+            });
+        for (; x < area_->width(); ++x) {
+            grid->paintCell({x, y}, sf::Color::Black);
         }
     }
 }
@@ -1,5 +1,7 @@
 #include "game_field.hpp"
 
+#include <algorithm>
+
 #include "player.hpp"
 
 namespace game_field {
@@ -8,168 +10,413 @@ GameFieldWithFigure::GameFieldWithFigure(
         int width, int height, 
         std::unique_ptr<factory::ICreatureFactory> creatFactory,
         std::unique_ptr<factory::ICellFactory> cellFactory,
-        std::unique_ptr<IFigure> figure) :
-    creatFactory_(std::move(creatFactory))
-    , cellFactory_(std::move(cellFactory))
+        std::unique_ptr<IFigure> figure,
+        topology::topology_t topology) :
+    GameFieldWithFigure(width, height,
+        std::move(creatFactory),
+        std::make_unique<cell_storage::CellObjectStorage>(
+            std::move(cellFactory)),
+        std::move(figure), topology)
+{}
+
+GameFieldWithFigure::GameFieldWithFigure(
+        int width, int height, 
+        std::unique_ptr<factory::ICreatureFactory> creatFactory,
+        std::unique_ptr<ICellStorage> storage,
+        std::unique_ptr<IFigure> figure,
+        topology::topology_t topology) :
+    GameFieldWithFigure(width, height,
+        std::move(creatFactory), std::move(storage), std::move(figure),
+        std::span<const stencil::offset_t>(stencil::Moore::offsets),
+        topology)
+{}
+
+GameFieldWithFigure::GameFieldWithFigure(
+        int width, int height, 
+        std::unique_ptr<factory::ICreatureFactory> creatFactory,
+        std::unique_ptr<ICellStorage> storage,
+        std::unique_ptr<IFigure> figure,
+        std::span<const stencil::offset_t> neighborsPos,
+        topology::topology_t topology) :
+    storage_(std::move(storage))
+    , creatFactory_(std::move(creatFactory))
     , figure_(std::move(figure))
-    
+    , neighborsPos_(neighborsPos.begin(), neighborsPos.end())
+    , mask_(width, height, *figure_)
+    , topology_(topology)
 {   
     initField_(width, height); 
-    initCells_();
+    tiles_ = active_tiles::ActiveTiles(width, height, topology_);
+    initNeighborTable_();
 }
 
 const creature::ICreature&
 GameFieldWithFigure::getCreatureByCell(int xidx, int yidx) const {
     verifyThenThrowCellPos_(xidx, yidx);
-    return field_.at(yidx).at(xidx)->creature();
+    return players_.creature(storage_->owner(xidx, yidx));
 }
 
 void GameFieldWithFigure::setCreatureInCell(int xidx, int yidx, 
     std::shared_ptr<player::Player> player)
 {   
     verifyThenThrowCellPos_(xidx, yidx);
-    auto creat = creatFactory_->createCreature(player);
-    field_.at(yidx).at(xidx)->setCreature(std::move(creat)); 
-    lastAffectedCell_ = { xidx, yidx }; 
-    fireCreatureSet_();
+    auto own = players_.registerPlayer(player, *creatFactory_);
+    auto prev = storage_->owner(xidx, yidx);
+    storage_->setOwner(xidx, yidx, own); 
+    ++version_;
+    countOwnerChange_(xidx, yidx, prev, own);
+    tiles_.markChanged(xidx, yidx);
+    if (auto changes = beginChanges_<game_event::CreatureSet>()) {
+        changes->add(xidx, yidx, own);
+        fireChanges_<game_event::CreatureSet>();
+    }
 }
 
 void GameFieldWithFigure::removeCreatureInCell(
     int xidx, int yidx)
 { 
     verifyThenThrowCellPos_(xidx, yidx);
-    field_.at(yidx).at(xidx)->removeCreature();
-    lastAffectedCell_ = { xidx, yidx }; 
-    fireCreatureRemove_();
+    auto prev = storage_->owner(xidx, yidx);
+    storage_->removeCreature(xidx, yidx);
+    ++version_;
+    countOwnerChange_(xidx, yidx, prev, cell_storage::emptyOwner);
+    tiles_.markChanged(xidx, yidx);
+    if (auto changes = beginChanges_<game_event::CreatureRemoved>()) {
+        changes->add(xidx, yidx, cell_storage::emptyOwner);
+        fireChanges_<game_event::CreatureRemoved>();
+    }
+}
+
+void GameFieldWithFigure::applyChanges(
+    std::span<const cell_storage::change_t> changes)
+{
+    // пакет проверяется целиком, чтобы не применить его частично
+    for (auto [x, y, own] : changes) {
+        verifyThenThrowCellPos_(x, y);
+        if (own != cell_storage::emptyOwner && !players_.contains(own)) {
+            throw std::logic_error("The owner is not registered.");
+        }
+    }
+    auto applied = beginChanges_<game_event::ChangesApplied>();
+    for (auto [x, y, own] : changes) {
+        auto prev = storage_->owner(x, y);
+        if (prev == own) continue;
+        storage_->setOwner(x, y, own);
+        ++version_;
+        countOwnerChange_(x, y, prev, own);
+        tiles_.markChanged(x, y);
+        if (applied) applied->add(x, y, own);
+    }
+    if (applied && !applied->empty()) {
+        fireChanges_<game_event::ChangesApplied>();
+    }
 }
 
 bool GameFieldWithFigure::hasCreatureInCell(
     int xidx, int yidx) const 
 { 
     verifyThenThrowCellPos_(xidx, yidx);
-    return field_.at(yidx).at(xidx)->hasCreature();
+    return storage_->hasCreature(xidx, yidx);
 }
 std::map<const std::shared_ptr<player::Player>, int> 
 GameFieldWithFigure::countCellNeighborsCreatures(int xidx, int yidx) const 
 { 
     verifyThenThrowCellPos_(xidx, yidx);
-    return field_.at(yidx).at(xidx)->countNeighborsCreatures();
+    cell_storage::neighbor_counts_t count;
+    storage_->countNeighborsCreatures(xidx, yidx, count);
+    std::map<const std::shared_ptr<player::Player>, int> res;
+    for (int id = 0; id < cell_storage::maxPlayers; ++id) {
+        if (count[id]) {
+            res[players_.player(id + 1)] = count[id];
+        }
+    }
+    return res;
+}
+
+void GameFieldWithFigure::countCellNeighborsCreatures(int xidx, int yidx,
+    cell_storage::neighbor_counts_t& count) const
+{
+    verifyThenThrowCellPos_(xidx, yidx);
+    storage_->countNeighborsCreatures(xidx, yidx, count);
 }
 
 void GameFieldWithFigure::clear() {
     int w = width();
     int h = height();
-    field_.clear();
+    // таблица соседей зависит только от топологии и не перестраивается
     initField_(w, h);
-    initCells_();
     fireFieldClear_();
 }
 
-std::pair<int, int> 
-GameFieldWithFigure::lastAffectedCell() const noexcept
-{ return lastAffectedCell_; }
+void GameFieldWithFigure::beginGeneration() {
+    storage_->beginGeneration();
+    tiles_.activate();
+}
+
+void GameFieldWithFigure::setNextOwner(int xidx, int yidx, 
+    cell_storage::owner_t owner) noexcept
+{ storage_->setNextOwner(xidx, yidx, owner); }
+
+void GameFieldWithFigure::swapGeneration() {
+    storage_->swapGeneration();
+    ++version_;
+    // собрать изменившиеся клетки в построчном порядке,
+    // клетки вне активных плиток измениться не могли
+    auto changes = beginChanges_<game_event::ChangesApplied>();
+    constexpr int tileSize = active_tiles::ActiveTiles::tileSize;
+    int w = width();
+    for (int y = 0; y < height(); ++y) {
+        // соседние активные плитки строки сравниваются одним отрезком
+        rowChanges_.clear();
+        for (int tx = 0; tx < tiles_.tilesX(); ++tx) {
+            if (!tiles_.isActive(tx, y / tileSize)) continue;
+            int begin = tx;
+            while (tx + 1 < tiles_.tilesX() && 
+                   tiles_.isActive(tx + 1, y / tileSize)) 
+            {
+                ++tx;
+            }
+            storage_->diffGeneration(y, begin * tileSize, 
+                std::min(w, (tx + 1) * tileSize), rowChanges_);
+        }
+        for (auto [x, prev, own] : rowChanges_) {
+            countOwnerChange_(x, y, prev, own);
+            tiles_.markChanged(x, y);
+            if (changes) changes->add(x, y, own);
+        }
+    }
+    // поколение - одно оповещение
+    if (changes && !changes->empty()) {
+        fireChanges_<game_event::ChangesApplied>();
+    }
+}
+
+const active_tiles::ActiveTiles& 
+GameFieldWithFigure::activeTiles() const noexcept
+{ return tiles_; }
+
+const cell_storage::population_t& 
+GameFieldWithFigure::population() const noexcept
+{ return population_; }
 
 int GameFieldWithFigure::width() const noexcept 
-{ return field_.back().size(); }
+{ return storage_->width(); }
 
 int GameFieldWithFigure::height() const noexcept 
-{ return field_.size(); }
+{ return storage_->height(); }
+
+cell_storage::owner_t GameFieldWithFigure::registerPlayer(
+    std::shared_ptr<player::Player> player)
+{ return players_.registerPlayer(player, *creatFactory_); }
 
 bool GameFieldWithFigure::isExcludedCell(
     int xidx, int yidx) const 
-{ return !figure_->isPointInFigure(xidx, yidx); }
+{ return !mask_.contains(xidx, yidx); }
+
+void GameFieldWithFigure::readSpan(int yidx, int xbegin, 
+    std::span<cell_storage::owner_t> owners,
+    std::span<cell_storage::neighbor_counts_t> counts) const
+{ storage_->readSpan(yidx, xbegin, owners, counts); }
+
+const figure_mask::FigureMask& 
+GameFieldWithFigure::figureMask() const noexcept
+{ return mask_; }
+
+topology::topology_t GameFieldWithFigure::topology() const noexcept
+{ return topology_; }
+
+const cell_storage::ICellStorage& 
+GameFieldWithFigure::storage() const noexcept
+{ return *storage_; }
 
-void GameFieldWithFigure::attach(
-    std::shared_ptr<observer::IObserver> obs, int event_t)
-{ ISubject::attach(obs, event_t); }
+const player::PlayerRegistry& 
+GameFieldWithFigure::players() const noexcept
+{ return players_; }
 
-void GameFieldWithFigure::detach(
-    std::weak_ptr<observer::IObserver> obs, int event_t)
-{ ISubject::detach(obs, event_t); }
+std::shared_ptr<const neighbor_table::NeighborTable>
+GameFieldWithFigure::neighborTable() const noexcept
+{ return neighborTable_; }
 
-void GameFieldWithFigure::notify(int event_t) {
-    ISubject::notify(event_t);
+std::span<const stencil::offset_t> 
+GameFieldWithFigure::neighborOffsets() const noexcept
+{ return neighborsPos_; }
+
+std::vector<std::pair<int, int>> 
+GameFieldWithFigure::cellsWithExtraNeighbors() const {
+    std::vector<std::pair<int, int>> res;
+    int w = width();
+    for (auto cell : neighborTable_->linkedCells()) {
+        res.emplace_back(cell % w, cell / w);
+    }
+    return res;
 }
 
-void GameFieldWithFigure::verifyThenThrowCellPos_(
-    int xidx, int yidx) const 
+int GameFieldWithFigure::trackRegion(
+    std::pair<int, int> upperLeftCorner,
+    std::pair<int, int> lowerRightCorner)
 {
-    if (isExcludedCell(xidx, yidx)) {
-        throw std::logic_error("Accessing a forbidden cell.");
+    int freeSlot = -1;
+    for (int i = 0; i < static_cast<int>(regions_.size()); ++i) {
+        auto&& r = regions_[i];
+        if (!r.refs) {
+            if (freeSlot < 0) freeSlot = i;
+        } else if (r.upperLeftCorner == upperLeftCorner && 
+                   r.lowerRightCorner == lowerRightCorner) 
+        {
+            ++r.refs;
+            return i;
+        }
+    }
+    region_t region{upperLeftCorner, lowerRightCorner, 1, {}};
+    // начальное количество считается один раз обходом прямоугольника
+    int y0 = std::max(upperLeftCorner.second, 0);
+    int y1 = std::min(lowerRightCorner.second, height() - 1);
+    for (int y = y0; y <= y1; ++y) {
+        mask_.forEachSpan(y, upperLeftCorner.first, 
+            lowerRightCorner.first + 1, [&] (int begin, int end) {
+                for (int x = begin; x < end; ++x) {
+                    ++region.population[storage_->owner(x, y)];
+                }
+            });
     }
+    region.population[cell_storage::emptyOwner] = 0;
+    if (freeSlot < 0) {
+        regions_.push_back(region);
+        return static_cast<int>(regions_.size()) - 1;
+    }
+    regions_[freeSlot] = region;
+    return freeSlot;
 }
 
-void GameFieldWithFigure::fireFieldClear_() {
-    int evt = static_cast<int>(
-        game_event::event_t::FIELD_CLEAR);   
-    notify(evt);
+void GameFieldWithFigure::untrackRegion(int region) {
+    if (region < 0 || region >= static_cast<int>(regions_.size()) ||
+        !regions_[region].refs)
+    {
+        throw std::out_of_range("The region is not tracked.");
+    }
+    --regions_[region].refs;
 }
 
-void GameFieldWithFigure::fireCreatureSet_() {
-    int evt = static_cast<int>(
-        game_event::event_t::CREATURE_SET_IN_FIELD);   
-    notify(evt);
+const cell_storage::population_t& 
+GameFieldWithFigure::regionPopulation(int region) const {
+    if (region < 0 || region >= static_cast<int>(regions_.size()) ||
+        !regions_[region].refs)
+    {
+        throw std::out_of_range("The region is not tracked.");
+    }
+    return regions_[region].population;
 }
 
-void GameFieldWithFigure::fireCreatureRemove_() {
-    int evt = static_cast<int>(
-            game_event::event_t::CREATURE_REMOVE_IN_FIELD);   
-    notify(evt);
+std::uint64_t GameFieldWithFigure::version() const noexcept
+{ return version_; }
+
+game_event::FieldBus& GameFieldWithFigure::events() noexcept
+{ return events_; }
+
+void GameFieldWithFigure::linkNeighbors_(
+    const std::map<std::pair<int, int>, std::pair<int, int>>& links)
+{
+    neighborTable_ = std::make_shared<const NeighborTable>(
+        neighborTable_->withLinks(links));
+    storage_->setNeighborTable(neighborTable_);
+    ++version_;
+    // соседи связанной клетки могут быть в далёкой плитке
+    for (auto&& [cell, ne] : links) {
+        tiles_.pin(cell.first, cell.second);
+    }
 }
 
-void GameFieldWithFigure::initField_(int width, int height) {
-    field_ = decltype(field_)();
-    for (int i = 0; i < height; ++i) {
-        std::vector<std::unique_ptr<cell::ICell>> r;
-        for (int j = 0; j < width; ++j) {
-            r.emplace_back(cellFactory_->createCell());
-        }
-        field_.emplace_back(std::move(r));
+void GameFieldWithFigure::verifyThenThrowCellPos_(
+    int xidx, int yidx) const 
+{
+    // маска фигуры совпадает с полем по размеру: клетка маски
+    // заведомо в пределах поля
+    if (mask_.contains(xidx, yidx)) return;
+    if (xidx < 0 || xidx >= width() || yidx < 0 || yidx >= height()) {
+        throw std::out_of_range("Cell position is out of range.");
     }
+    throw std::logic_error("Accessing a forbidden cell.");
 }
 
-std::pair<int, int>GameFieldWithFigure::clampToSphere_(int x, int y) const {
-    int n_x = x;
-    int n_y = y;
+void GameFieldWithFigure::countOwnerChange_(int xidx, int yidx,
+    cell_storage::owner_t from, cell_storage::owner_t to) noexcept
+{
+    if (from == to) return;
+    // счётчик пустых клеток не ведётся
+    auto move = [from, to] (cell_storage::population_t& population) {
+        if (from != cell_storage::emptyOwner) --population[from];
+        if (to != cell_storage::emptyOwner) ++population[to];
+    };
+    move(population_);
+    for (auto&& r : regions_) {
+        if (r.refs &&
+            xidx >= r.upperLeftCorner.first && 
+            xidx <= r.lowerRightCorner.first &&
+            yidx >= r.upperLeftCorner.second && 
+            yidx <= r.lowerRightCorner.second)
+        {
+            move(r.population);
+        }
+    }
+}
 
-    if (x < 0) n_x = width() - 1;
-    else if (x >= width()) n_x = 0;
+void GameFieldWithFigure::fireFieldClear_() {
+    events_.publish(game_event::FieldCleared{});
+}
 
-    if (y < 0) n_y = height() - 1;
-    else if (y >= height()) n_y = 0;
+template <class Event>
+change_set::ChangeSet* GameFieldWithFigure::beginChanges_() {
+    if (!events_.hasSubscribers<Event>()) {
+        return nullptr;
+    }
+    changes_ = changesPool_.acquire(width(), changeSequence_);
+    return changes_.get();
+}
 
-    return {n_x, n_y};
+template <class Event>
+void GameFieldWithFigure::fireChanges_() {
+    ++changeSequence_;
+    // поле не держит набор: он вернётся в пул, когда его освободит
+    // последний обработчик
+    events_.publish(Event{ std::move(changes_) });
 }
 
+void GameFieldWithFigure::initField_(int width, int height) {
+    storage_->reset(width, height);
+    ++version_;
+    tiles_.markAllChanged();
+    population_.fill(0);
+    for (auto&& r : regions_) {
+        r.population.fill(0);
+    }
+}
 
-void GameFieldWithFigure::initCells_() {
+void GameFieldWithFigure::initNeighborTable_() {
+    std::vector<std::uint32_t> offsets{0};
+    std::vector<std::uint32_t> indices;
+    offsets.reserve(static_cast<std::size_t>(width()) * height() + 1);
+    indices.reserve(static_cast<std::size_t>(width()) * height() 
+                    * neighborsPos_.size());
+    // края соединяются один раз при построении таблицы
+    bool wrapsX = topology::wrapsX(topology_);
+    bool wrapsY = topology::wrapsY(topology_);
     for (int i = 0; i < height(); ++i) {
         for (int j = 0; j < width(); ++j) {
-            auto&& cell = field_[i][j];
-            for (auto [x, y] : neighborsPos_) {
-                y += i;
-                x += j;
-#ifndef TEST
-                auto clamp = clampToSphere_(x, y);
-                int clampX = clamp.first;
-                int clampY = clamp.second;
-                if (!isExcludedCell(clampX, clampY)) 
-#else           
-                if (!isExcludedCell(x, y) &&
-                    y >= 0 && y < height() &&
-                    x >= 0 && x < width()) 
-#endif
-                {
-#ifndef  TEST
-                    auto&& ne = field_[clampY][clampX];
-#else               
-                    auto&& ne = field_[y][x];
-#endif
-                    cell->addNeighbors(ne.get());
+            for (auto [dx, dy] : neighborsPos_) {
+                int x = topology::wrap(j + dx, width(), wrapsX);
+                int y = topology::wrap(i + dy, height(), wrapsY);
+                // клетки вне поля исключены
+                if (!isExcludedCell(x, y)) {
+                    indices.push_back(
+                        static_cast<std::uint32_t>(y) * width() + x);
                 }
             }
+            offsets.push_back(indices.size());
         }
     }
+    neighborTable_ = std::make_shared<const NeighborTable>(
+        width(), height(), std::move(offsets), std::move(indices));
+    storage_->setNeighborTable(neighborTable_);
 }
 
 }
\ No newline at end of file
@@ -16,7 +16,13 @@ GameFieldWithFigureArea::GameFieldWithFigureArea(
     std::pair<int, int> upperLeftCorner, 
     std::pair<int, int> lowerRightCorner) :
     IGameFieldArea(upperLeftCorner, lowerRightCorner)
-{ field_ = field; }
+{ 
+    field_ = field; 
+    region_ = field_->trackRegion(upperLeftCorner, lowerRightCorner);
+}
+
+GameFieldWithFigureArea::~GameFieldWithFigureArea() 
+{ field_->untrackRegion(region_); }
 
 void GameFieldWithFigureArea::lock() noexcept {
     isLocked_ = true;
@@ -26,6 +32,10 @@ void GameFieldWithFigureArea::unlock() noexcept {
     isLocked_ = false;
 }
 
+bool GameFieldWithFigureArea::isLocked() const noexcept {
+    return isLocked_;
+}
+
 bool GameFieldWithFigureArea::isCellAvailable(
     int xidx, int yidx) const
 {
@@ -48,6 +58,15 @@ void GameFieldWithFigureArea::removeCreatureInCell(
     field_->removeCreatureInCell(xidx, yidx);
 }  
 
+void GameFieldWithFigureArea::applyChanges(
+    std::span<const cell_storage::change_t> changes)
+{
+    for (auto [x, y, own] : changes) {
+        verifyThenThrowCellPos_(x, y);
+    }
+    field_->applyChanges(changes);
+}
+
 const creature::ICreature& 
 GameFieldWithFigureArea::getCreatureByCell(int xidx, int yidx) const 
 {
@@ -62,6 +81,18 @@ GameFieldWithFigureArea::countCellNeighborsCreatures(int xidx, int yidx) const
     return field_->countCellNeighborsCreatures(xidx, yidx);
 }
 
+void GameFieldWithFigureArea::countCellNeighborsCreatures(int xidx, int yidx,
+    cell_storage::neighbor_counts_t& count) const
+{
+    verifyThenThrowCellPos_(xidx, yidx);
+    field_->countCellNeighborsCreatures(xidx, yidx, count);
+}
+
+void GameFieldWithFigureArea::readSpan(int yidx, int xbegin,
+    std::span<cell_storage::owner_t> owners,
+    std::span<cell_storage::neighbor_counts_t> counts) const
+{ field_->readSpan(yidx, xbegin, owners, counts); }
+
 bool GameFieldWithFigureArea::hasCreatureInCell(
     int xidx, int yidx) const 
 {
@@ -72,24 +103,25 @@ std::set<std::shared_ptr<player::Player>>
     GameFieldWithFigureArea::checkCreatureInArea() const 
 {
     std::set<std::shared_ptr<player::Player>> res;
-    auto corner = upperLeftCorner_;
-    for (auto y = corner.second; 
-        y <= lowerRightCorner_.second; ++y) 
-    {
-        for (auto x = corner.first; 
-            x <= lowerRightCorner_.first; ++x) 
-        {
-            if (isCellAvailable(x, y)) {
-                if (field_->hasCreatureInCell(x, y)) {
-                    auto&& cr = field_->getCreatureByCell(x, y);
-                    res.emplace(cr.player());
-                }
-            }
+    // закрытая зона возвращает нулевые количества
+    auto&& pop = population();
+    for (int own = 1; own < static_cast<int>(pop.size()); ++own) {
+        if (pop[own]) {
+            res.emplace(field_->players().player(own));
         }
     }
     return res;
 }
 
+const cell_storage::population_t& 
+GameFieldWithFigureArea::population() const
+{
+    // в закрытой зоне нет доступных клеток, как и для checkCreatureInArea
+    static constexpr cell_storage::population_t lockedPopulation{};
+    if (isLocked_) return lockedPopulation;
+    return field_->regionPopulation(region_);
+}
+
 void GameFieldWithFigureArea::clear() {
     if (width() == field_->width() && 
         height() == field_->height()) 
@@ -98,20 +130,38 @@ void GameFieldWithFigureArea::clear() {
     } 
     else 
     {
+        // удалить существа зоны одним пакетом
+        std::vector<cell_storage::change_t> changes;
+        auto&& mask = field_->figureMask();
         for (int y = upperLeftCorner_.second; 
                 y <= lowerRightCorner_.second; ++y)
         {
-            for (int x = upperLeftCorner_.first; 
-                x <= lowerRightCorner_.second; ++x) 
-            {   
-                if (!field_->isExcludedCell(x, y)) {
-                    field_->removeCreatureInCell(x, y);
-                }
-            }
+            mask.forEachSpan(y, upperLeftCorner_.first, 
+                lowerRightCorner_.first + 1, [&] (int begin, int end) {
+                    for (int x = begin; x < end; ++x) {
+                        changes.emplace_back(
+                            x, y, cell_storage::emptyOwner);
+                    }
+                });
         }
+        field_->applyChanges(changes);
     }
 }
 
+void GameFieldWithFigureArea::beginGeneration()
+{ field_->beginGeneration(); }
+
+void GameFieldWithFigureArea::setNextOwner(int xidx, int yidx, 
+    cell_storage::owner_t owner) noexcept
+{ field_->setNextOwner(xidx, yidx, owner); }
+
+void GameFieldWithFigureArea::swapGeneration()
+{ field_->swapGeneration(); }
+
+const active_tiles::ActiveTiles& 
+GameFieldWithFigureArea::activeTiles() const noexcept
+{ return field_->activeTiles(); }
+
 std::pair<int, int> 
 GameFieldWithFigureArea::upperLeftCorner() const noexcept 
 { return upperLeftCorner_; }
@@ -132,9 +182,14 @@ int GameFieldWithFigureArea::height() const noexcept  {
             + 1;
 }
 
+const figure_mask::FigureMask& 
+GameFieldWithFigureArea::figureMask() const noexcept 
+{ return field_->figureMask(); }
+
 void GameFieldWithFigureArea::verifyThenThrowCellPos_(
     int xidx, int yidx) const {
-    if (!isCellAvailable(xidx, yidx)) {
+    // клетку вне фигуры отклоняет поле: маска проверяется один раз
+    if (isLocked_ || !IGameFieldArea::isCellAvailable(xidx, yidx)) {
         throw std::logic_error("Accessing a forbidden cell.");
     }
 }
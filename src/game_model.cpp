@@ -4,20 +4,16 @@
 #include <numeric>
 #include <array>
 #include <tuple>
-#include <iterator>
 #include <chrono>
-#include <thread>
-#include <ranges>
 #include <random>
 
 namespace {
     using IGameFieldArea = game_field_area::IGameFieldArea;
     using IGameFieldAreaCurryFactory = factory::IGameFieldAreaCurryFactory;
 
-    
-    bool computeLiveStatusConwayGame(bool isAlive, int neighborsCount) {
-        return (neighborsCount == 2 && isAlive) || neighborsCount == 3;
-    }
+    // ожидание ввода не дольше кадра отрисовки
+    constexpr auto inputWait = std::chrono::milliseconds(16);
+    constexpr auto erPeriod = std::chrono::milliseconds(250);
 
 } // namespace 
 
@@ -30,54 +26,49 @@ GameModel::GameModel(
         std::unique_ptr<IGameFieldArea> area, 
         std::unique_ptr<IGameFieldAreaCurryFactory> areaFactory,
         const std::vector<std::shared_ptr<player::Player>>& players,
-        std::unique_ptr<ICreatureStrategy> creatStrategy) :
+        std::unique_ptr<ICreatureStrategy> creatStrategy,
+        std::unique_ptr<IGameEngine> engine,
+        std::unique_ptr<thread_pool::ThreadPool> pool) :
     creatNumberFirstTime_(creatNumberFirstTime)
     , creatNumber_(creatNumber)
     , erCount_(erCount)
-    , area_(std::move(area))
+    , inbox_(std::make_shared<game_event::InputQueue>())
     , areaFactory_(std::move(areaFactory))
+    , area_(std::move(area))
+    , engine_(std::move(engine))
+    , pool_(std::move(pool))
+    , rule_(creatStrategy->transitionTable())
     , players_(players)
-    , creatStrategy_(std::move(creatStrategy))
+    , rng_(std::random_device{}())
 {
     giveAreasForTwoPlayers_();
 }
 
-void GameModel::attach(
-    std::shared_ptr<observer::IObserver> obs, int event_t) 
-{ subject::ISubject::attach(obs, event_t); }
+void GameModel::on(const game_event::UserAskedClose&) {
+    askedClose_ = true;
+}
 
-void GameModel::detach(
-    std::weak_ptr<observer::IObserver> obs, int event_t) 
-{ subject::ISubject::detach(obs, event_t); }
+void GameModel::on(const game_event::UserAskedRestart&) {
+    askedRestart_ = true;
+    restartModel_();
+}
 
-void GameModel::notify(int event_t) 
-{ subject::ISubject::notify(event_t); }
+void GameModel::on(const game_event::UserAskedSetCreature& evt) {
+    // поле меняется только в потоке модели
+    if (setupPhase_ && curPlayer_) {
+        curPlayer_->tapOnCreature(evt.xidx, evt.yidx);
+    }
+}
 
-void GameModel::update(int event_t)
-{
-    using evt_t = game_event::event_t;
-    auto evt = static_cast<evt_t>(event_t);
-    switch (evt) {
-        case evt_t::USER_ASKED_CLOSE: {
-            askedClose_ = true;
-            break;
-        }
-        case evt_t::USER_ASKED_RESTART: { 
-            askedRestart_ = true;
-            restartModel_();
-            break;
-        }
-        case evt_t::CREATURE_REMOVE_IN_FIELD: {
-            if (setupPhase_) {
-                ++curPlayerCreatNumber_;
-            }   
-            break;
-        }
-        case evt_t::CREATURE_SET_IN_FIELD: { 
-            if (setupPhase_) {
-                --curPlayerCreatNumber_;
-            }
-        }
+void GameModel::on(const game_event::CreatureSet&) {
+    if (setupPhase_) {
+        --curPlayerCreatNumber_;
+    }
+}
+
+void GameModel::on(const game_event::CreatureRemoved&) {
+    if (setupPhase_) {
+        ++curPlayerCreatNumber_;
     }
 }
 
@@ -92,6 +83,7 @@ void GameModel::game() {
         roundIsOver_ = false;
         while ((!askedRestart_) && (!askedClose_)) {
             fireUserInputRequired();
+            awaitInput_();
         }
     } 
 }
@@ -114,6 +106,26 @@ int GameModel::erRemained() const noexcept  {
     return erRemained_;
 }
 
+game_event::ModelBus& GameModel::events() noexcept {
+    return events_;
+}
+
+std::shared_ptr<game_event::InputQueue> GameModel::inbox() const noexcept {
+    return inbox_;
+}
+
+const thread_pool::ThreadPool* GameModel::threadPool() const noexcept {
+    return pool_.get();
+}
+
+void GameModel::setSeed(std::uint64_t seed) noexcept {
+    rng_ = counter_rng::CounterRng(seed);
+}
+
+std::uint64_t GameModel::seed() const noexcept {
+    return rng_.key();
+}
+
 void GameModel::giveAreasForTwoPlayers_() {
     std::pair<int, int> ul1 = {0, 0};
     std::pair<int, int> lr1 = {area_->width() / 2 - 1, 
@@ -142,16 +154,22 @@ void GameModel::setupFieldForPlayer_(int creatureNumber,
     auto&& area = player->fieldArea();
     curPlayerCreatNumber_ = creatureNumber;
     area.unlock();
+    int shown = -1;
     while (curPlayerCreatNumber_ && !askedClose_ && !askedRestart_) {
-        firePlayerBetsCreatures_();
+        // ход показывается, когда меняется количество существ
+        if (shown != curPlayerCreatNumber_) {
+            shown = curPlayerCreatNumber_;
+            firePlayerBetsCreatures_();
+        }
         fireUserInputRequired();
+        awaitInput_();
     } 
     area.lock();
     setupPhase_ = false;
 }
 
 void GameModel::computeErs_(int erCount) {
-    while (!roundIsOver_ && erCount) {
+    while (!roundIsOver_ && erCount && !askedClose_ && !askedRestart_) {
         erRemained_ = erCount--;
         fireGameModelCalculatedEr_();
         auto [suc, win, player] = computeEr_(); 
@@ -164,90 +182,175 @@ void GameModel::computeErs_(int erCount) {
                 fireWinnerDeterminate_();
             }
         } else {
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(250));
+            pause_(erPeriod);
         }
     }
 }
 
+void GameModel::awaitInput_() {
+    inbox_->waitAndDispatch(*this, inputWait);
+}
+
+void GameModel::pause_(std::chrono::milliseconds period) {
+    auto deadline = std::chrono::steady_clock::now() + period;
+    while (!askedClose_ && !askedRestart_) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) break;
+        inbox_->waitAndDispatch(*this, deadline - now);
+    }
+}
+
 std::tuple<bool, bool, std::shared_ptr<player::Player>> 
 GameModel::computeEr_() 
 {
-    // рассчитать состояние поля в следующий момент и отложить его
-    computeAside_();
-    // применить отложенное состояние на поле
-    applyNClearAside_();
-    // получить всех список игроков, чьи существа еще есть на поле
-    auto count = area_->checkCreatureInArea();
-    if (count.size() < 2) {
-        if (count.size() == 1) {
-            return {false, true, *count.begin()};
+    generationRng_ = rng_.stream(generation_++);
+    if (engine_) {
+        // рассчитать и применить следующее поколение движком
+        engine_->computeEr(*area_, rule_, generationRng_);
+    } else {
+        // рассчитать состояние поля в следующий момент во втором буфере
+        computeNextGeneration_();
+        // сделать его текущим
+        area_->swapGeneration();
+    }
+    // количество существ поддерживается полем, 
+    // проверка обходит только игроков
+    auto&& population = area_->population();
+    std::shared_ptr<player::Player> alive;
+    int aliveCount = 0;
+    for (auto&& p : players_) {
+        if (population[player::PlayerRegistry::ownerOf(*p)]) {
+            alive = p;
+            ++aliveCount;
+        }
+    }
+    if (aliveCount < 2) {
+        if (aliveCount == 1) {
+            return {false, true, alive};
         } 
         return {false, false, nullptr};
     }
     return {true, false, nullptr};
 } 
 
-void GameModel::computeAside_() {
-    namespace views = std::ranges::views;
+void GameModel::computeNextGeneration_() {
+    // клетки вне зоны и вне активных плиток 
+    // переходят в следующее поколение без изменений
+    area_->beginGeneration();
+    collectTileTasks_();
+
+    // плитки считаются независимо, изменения копятся в буфере потока;
+    // порядок применения не важен - каждая клетка меняется один раз
+    int workers = pool_ ? pool_->threadCount() : 1;
+    if (static_cast<int>(workerChanges_.size()) < workers) {
+        workerChanges_.resize(workers);
+    }
+    auto computeTask = [&] (int task, int worker) {
+        auto [tx, ty] = tileTasks_[task];
+        computeTile_(tx, ty, workerChanges_[worker]);
+    };
+    int tasks = static_cast<int>(tileTasks_.size());
+    if (pool_) {
+        pool_->parallelFor(tasks, computeTask);
+    } else {
+        for (int task = 0; task < tasks; ++task) {
+            computeTask(task, 0);
+        }
+    }
+
+    for (auto&& changes : workerChanges_) {
+        for (auto [x, y, own] : changes) {
+            area_->setNextOwner(x, y, own);
+        }
+        changes.clear();
+    }
+}
+
+void GameModel::collectTileTasks_() {
+    constexpr int tileSize = active_tiles::ActiveTiles::tileSize;
+    auto luCorner = area_->upperLeftCorner();
+    auto rdCorner = area_->lowerRightCorner();
+    auto&& tiles = area_->activeTiles();
+
+    tileTasks_.clear();
+    for (int ty = luCorner.second / tileSize; 
+         ty <= rdCorner.second / tileSize; ++ty) 
+    {
+        for (int tx = luCorner.first / tileSize; 
+             tx <= rdCorner.first / tileSize; ++tx) 
+        {
+            if (tiles.isActive(tx, ty)) {
+                tileTasks_.emplace_back(tx, ty);
+            }
+        }
+    }
+}
+
+void GameModel::computeTile_(int tileX, int tileY, 
+    std::vector<change_t>& changes) const 
+{
+    constexpr int tileSize = active_tiles::ActiveTiles::tileSize;
     auto luCorner = area_->upperLeftCorner();
     auto rdCorner = area_->lowerRightCorner();
+    // пересечение плитки с зоной
+    int x0 = std::max(luCorner.first, tileX * tileSize);
+    int x1 = std::min(rdCorner.first, tileX * tileSize + tileSize - 1);
+    int y0 = std::max(luCorner.second, tileY * tileSize);
+    int y1 = std::min(rdCorner.second, tileY * tileSize + tileSize - 1);
     
-    for (auto y = luCorner.second; y <= rdCorner.second; ++y) {
-        for (auto x = luCorner.first; x <= rdCorner.first; ++x) {
-            if (area_->isCellAvailable(x, y)) {
-                auto ne = area_->countCellNeighborsCreatures(x, y);
-                // посчитать количество существ всех игроков в соседях
-                int neSum = std::accumulate(ne.begin(), ne.end(), 
-                                0, [] (int i, auto&& p) { return i + p.second; });
-                // если существо есть в клетке - оно живо
-                bool isAlive = area_->hasCreatureInCell(x, y);
-
-                // принять решение через стратегию 
-                if (creatStrategy_->computeLiveStatus(neSum, isAlive)) {
-                    if (!isAlive) {
-                        // получить значение с максимальным количеством существ 
-                        auto max = std::max_element(ne.begin(), ne.end(), 
-                                                    [] (auto&& l, auto&& p) 
-                                                    { return l.second < p.second; });
-                        // получить все максимумы 
-                        auto matchingMax = ne | 
-                            views::filter([&max](auto&& v) 
-                                    { return v.second == max->second; });
-                        // получить количество максимумов
-                        auto szMax = std::distance(matchingMax.begin(), 
-                                                    matchingMax.end());
-                        // получить случайный максимум из равных
-                        std::random_device r;
-                        std::default_random_engine e1(r());
-                        std::uniform_int_distribution<int> uniform_dist(0, szMax - 1);
-                        int mean = uniform_dist(e1);
-                        auto resMax = matchingMax.begin();
-                        std::advance(resMax, mean);
-                        // получить игрока из максимума
-                        auto player = resMax->first;
-
-                        // поставить существо (даже если оно там уже есть)
-                        aside_.emplace_back(player, true, x, y);
+    // отрезок не длиннее плитки: клетки читаются одним вызовом на отрезок,
+    // цикл по клеткам обходится без виртуальных вызовов и проверок
+    std::array<cell_storage::owner_t, tileSize> owners;
+    std::array<cell_storage::neighbor_counts_t, tileSize> counts;
+    auto computeSpan = [&] (int y, int begin, int end) {
+        std::size_t len = end - begin;
+        area_->readSpan(y, begin, std::span(owners).first(len),
+                        std::span(counts).first(len));
+        for (std::size_t i = 0; i < len; ++i) {
+            int x = begin + static_cast<int>(i);
+            auto&& ne = counts[i];
+            // посчитать количество существ всех игроков в соседях
+            int neSum = std::accumulate(ne.begin(), ne.end(), 0);
+            // если существо есть в клетке - оно живо
+            bool isAlive = owners[i] != cell_storage::emptyOwner;
+
+            // принять решение по правилу стратегии
+            if (rule_.next(isAlive, neSum)) {
+                if (!isAlive) {
+                    auto own = chooseOwner_(ne, x, y);
+                    if (own != cell_storage::emptyOwner) {
+                        // поставить существо игрока
+                        changes.emplace_back(x, y, own);
                     }
-                } else if (isAlive) {
-                    // удалить существо (даже если его нет в клетке)
-                    aside_.emplace_back(nullptr, false, x, y);
                 }
+            } else if (isAlive) {
+                // удалить существо
+                changes.emplace_back(x, y, cell_storage::emptyOwner);
             }
         }
+    };
+    for (auto y = y0; y <= y1; ++y) {
+        // обходятся только отрезки клеток фигуры
+        area_->forEachAvailableSpan(y, x0, x1 + 1, 
+            [&] (int begin, int end) { computeSpan(y, begin, end); });
     }
 }
 
-void GameModel::applyNClearAside_() {
-    for (auto [player, set, x, y] : aside_) {
-        if (set) {
-            area_->setCreatureInCell(x, y, player);
-        } else {
-            area_->removeCreatureInCell(x, y);
-        }
-    }
-    aside_.clear();
+cell_storage::owner_t GameModel::chooseOwner_(
+    const cell_storage::neighbor_counts_t& ne, int x, int y) const 
+{
+    // получить максимальное количество существ 
+    int max = *std::max_element(ne.begin(), ne.end());
+    if (!max) return cell_storage::emptyOwner;
+    // получить количество максимумов
+    int szMax = std::count(ne.begin(), ne.end(), max);
+    // выбрать один из равных максимумов по клетке и поколению,
+    // чтобы результат не зависел от количества потоков
+    int mean = generationRng_.uniform(szMax, x, y);
+    // получить id игрока из выбранного максимума
+    int id = 0;
+    while (ne[id] != max || mean--) ++id;
+    return static_cast<cell_storage::owner_t>(id + 1);
 }
 
 void GameModel::restartModel_() {
@@ -255,33 +358,25 @@ void GameModel::restartModel_() {
 }
 
 void GameModel::fireWinnerDeterminate_() {
-    int evt = static_cast<int>(
-        game_event::event_t::WINNER_DETERMINATE);
-    notify(evt);   
+    events_.publish(game_event::WinnerDetermined{ winnerPlayer_ });
 }
 
 void GameModel::fireThereWasDraw_() {
-    int evt = static_cast<int>(
-        game_event::event_t::DRAW_DETERMINATE);
-    notify(evt);   
+    events_.publish(game_event::DrawDetermined{});
 }
 
 void GameModel::firePlayerBetsCreatures_() {
-    int evt = static_cast<int>(
-        game_event::event_t::PLAYER_BETS_CREATURES);
-    notify(evt);   
+    events_.publish(game_event::PlayerBetsCreatures{ 
+        curPlayer_, curPlayerCreatNumber_ });
 }
 
 void GameModel::fireGameModelCalculatedEr_() {
-    int evt = static_cast<int>(
-        game_event::event_t::GAME_MODEL_CALCULATED_ER);
-    notify(evt);   
+    events_.publish(game_event::ErCalculated{ 
+        erRemained_, area_->population() });
 }
 
 void GameModel::fireUserInputRequired() {
-    int evt = static_cast<int>(
-        game_event::event_t::USER_INPUT_REQUIRED);
-    notify(evt);   
+    events_.publish(game_event::UserInputRequired{});
 }
 
 
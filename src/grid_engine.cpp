@@ -0,0 +1,150 @@
+#include "grid_engine.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "player.hpp"
+
+namespace game_engine {
+
+GridGameEngine::GridGameEngine(
+    std::shared_ptr<GameFieldWithFigure> field,
+    std::span<const stencil::offset_t> neighborhood) :
+    field_(field)
+{
+    auto fieldNeighborhood = field_->neighborOffsets();
+    if (!std::is_permutation(
+            fieldNeighborhood.begin(), fieldNeighborhood.end(),
+            neighborhood.begin(), neighborhood.end()))
+    {
+        throw std::logic_error(
+            "The engine neighborhood differs from the field neighborhood.");
+    }
+}
+
+void GridGameEngine::computeEr(
+    game_field_area::IGameFieldArea& area,
+    const TransitionTable& rule,
+    const counter_rng::CounterRng& rng)
+{
+    auto&& storage = flatStorage_();
+    rule_ = rule;
+    rng_ = rng;
+    // рассчитать изменения для соседей Мура
+    computeChanges_(storage);
+    // пересчитать клетки с дополнительными соседями через поле
+    computeExtraNeighborsChanges_(storage);
+    applyChanges_(area);
+}
+
+cell_storage::owner_t 
+GridGameEngine::chooseOwner_(
+    const owner_counts_t& count, int x, int y) const 
+{
+    int max = 0;
+    std::array<owner_t, cell_storage::maxPlayers> matchingMax;
+    int szMax = 0;
+    for (int own = 1; own < static_cast<int>(count.size()); ++own) {
+        if (count[own] > max) {
+            max = count[own];
+            szMax = 0;
+        }
+        if (count[own] && count[own] == max) {
+            matchingMax[szMax++] = static_cast<owner_t>(own);
+        }
+    }
+    if (!szMax) {
+        return cell_storage::emptyOwner;
+    }
+    // единственный владелец с наибольшим количеством соседей
+    if (szMax == 1) {
+        return matchingMax[0];
+    }
+    return matchingMax[rng_.uniform(szMax, x, y)];
+}
+
+const cell_storage::FlatCellStorage&
+GridGameEngine::flatStorage_() const
+{
+    auto storage =
+        dynamic_cast<const FlatCellStorage*>(&field_->storage());
+    if (!storage) {
+        throw std::logic_error(
+            "The grid engine requires the FlatCellStorage");
+    }
+    return *storage;
+}
+
+void GridGameEngine::cacheExtraCells_() {
+    auto table = field_->neighborTable();
+    if (table == extraTable_) return;
+    extraTable_ = table;
+    extraCells_ = table->linkedCells();
+    std::sort(extraCells_.begin(), extraCells_.end());
+    extraCells_.erase(std::unique(extraCells_.begin(), extraCells_.end()),
+                      extraCells_.end());
+    isExtra_.assign(
+        static_cast<std::size_t>(table->width()) * table->height(), false);
+    for (auto cell : extraCells_) {
+        isExtra_[cell] = true;
+    }
+}
+
+void GridGameEngine::computeExtraNeighborsChanges_(
+    const FlatCellStorage& storage)
+{
+    cacheExtraCells_();
+    if (extraCells_.empty()) return;
+
+    int w = storage.width();
+    std::erase_if(changes_, [this, w] (auto&& ch) {
+        auto [x, y, own] = ch;
+        return isExtra_[static_cast<std::size_t>(y) * w + x];
+    });
+
+    cell_storage::neighbor_counts_t ne;
+    for (auto cell : extraCells_) {
+        int x = static_cast<int>(cell % w);
+        int y = static_cast<int>(cell / w);
+        storage.countNeighborsCreatures(x, y, ne);
+        int neSum = 0;
+        owner_counts_t count{};
+        for (int id = 0; id < cell_storage::maxPlayers; ++id) {
+            neSum += ne[id];
+            count[id + 1] = ne[id];
+        }
+        bool isAlive = storage.owner(x, y) != cell_storage::emptyOwner;
+        if (rule_.next(isAlive, neSum)) {
+            if (!isAlive) {
+                auto own = chooseOwner_(count, x, y);
+                if (own != cell_storage::emptyOwner) {
+                    changes_.emplace_back(x, y, own);
+                }
+            }
+        } else if (isAlive) {
+            changes_.emplace_back(x, y, cell_storage::emptyOwner);
+        }
+    }
+
+    // вернуть построчный порядок изменений
+    std::sort(changes_.begin(), changes_.end(),
+        [] (auto&& l, auto&& r) {
+            return std::tie(std::get<1>(l), std::get<0>(l)) <
+                   std::tie(std::get<1>(r), std::get<0>(r));
+        });
+}
+
+void GridGameEngine::applyChanges_(
+    game_field_area::IGameFieldArea& area)
+{
+    // клетки вне зоны не меняются, остальные применяются одним пакетом
+    std::erase_if(changes_, [&area] (auto&& ch) {
+        auto [x, y, own] = ch;
+        return !area.isCellAvailable(x, y);
+    });
+    area.applyChanges(changes_);
+    changesApplied_(flatStorage_());
+    changes_.clear();
+}
+
+} // namespace game_engine
@@ -0,0 +1,520 @@
+#include "hashlife.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    constexpr int initialLevel = 3;
+    // узлов в таблице, после которых неиспользуемые узлы удаляются
+    constexpr std::size_t gcThreshold = std::size_t(1) << 22;
+
+    // сторона узла уровня level
+    hashlife::coord_t side(int level) {
+        return hashlife::coord_t(1) << level;
+    }
+
+} // namespace
+
+namespace hashlife {
+
+std::size_t Universe::NodeKeyHash::operator()(
+    const std::array<node_t, 4>& key) const noexcept
+{
+    std::uint64_t h = 0;
+    for (auto c : key) {
+        h = (h ^ c) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 29;
+    }
+    return static_cast<std::size_t>(h);
+}
+
+Universe::Universe(const rule_t& birth, const rule_t& survive) :
+    birth_(birth)
+    , survive_(survive)
+{
+    for (int color = 0; color <= maxColors; ++color) {
+        Node leaf{{}, 0, {}};
+        if (color) leaf.pop[color - 1] = 1;
+        nodes_.push_back(leaf);
+    }
+    empties_.push_back(leaf_(0));
+    root_ = empty_(initialLevel);
+    rootLevel_ = initialLevel;
+}
+
+void Universe::setCell(coord_t xidx, coord_t yidx, owner_t owner) {
+    int color = owner == cell_storage::emptyOwner ? 0 : colorOf_(owner);
+    if (owner != cell_storage::emptyOwner && !color) {
+        color = addColor_(owner);
+    }
+    while (xidx < -half_() || xidx >= half_() ||
+           yidx < -half_() || yidx >= half_())
+    {
+        expand_();
+    }
+    root_ = set_(root_, xidx + half_(), yidx + half_(), color);
+}
+
+owner_t Universe::cell(coord_t xidx, coord_t yidx) const {
+    if (xidx < -half_() || xidx >= half_() ||
+        yidx < -half_() || yidx >= half_())
+    {
+        return cell_storage::emptyOwner;
+    }
+    xidx += half_();
+    yidx += half_();
+    node_t node = root_;
+    for (int level = rootLevel_; level > 0; --level) {
+        if (!totalPop_(node)) return cell_storage::emptyOwner;
+        coord_t h = side(level - 1);
+        int q = (xidx >= h) + 2 * (yidx >= h);
+        xidx %= h;
+        yidx %= h;
+        node = nodes_[node].child[q];
+    }
+    return colorOwner_[node];
+}
+
+void Universe::load(
+    int width, int height, const std::vector<owner_t>& cells)
+{
+    for (auto own : cells) {
+        if (own != cell_storage::emptyOwner && !colorOf_(own)) {
+            addColor_(own);
+        }
+    }
+    int level = initialLevel;
+    while (side(level) < width || side(level) < height) ++level;
+    // поле кладётся в юго-восточную четверть корня с центром в (0, 0)
+    auto quarter = build_(level, 0, 0, width, height, cells);
+    auto e = empty_(level);
+    root_ = join_(e, e, e, quarter);
+    rootLevel_ = level + 1;
+}
+
+void Universe::store(
+    int width, int height, std::vector<owner_t>& cells) const
+{
+    cells.assign(static_cast<std::size_t>(width) * height,
+                 cell_storage::emptyOwner);
+    store_(root_, -half_(), -half_(), width, height, cells);
+}
+
+void Universe::clip(coord_t x0, coord_t y0, coord_t x1, coord_t y1)
+{ root_ = clip_(root_, -half_(), -half_(), x0, y0, x1, y1); }
+
+void Universe::step(int stepLog2) {
+    if (!isDeterministic()) {
+        throw std::logic_error(
+            "The rule is not supported by the colored HashLife.");
+    }
+    if (nodes_.size() > gcThreshold) {
+        collectGarbage_();
+    }
+    // узел результата должен вместить всё, что вырастет за 2^stepLog2
+    while (rootLevel_ < stepLog2 + 2 || !isCentered_()) {
+        expand_();
+    }
+    expand_();
+    root_ = successor_(root_, stepLog2);
+    --rootLevel_;
+    generation_ += std::uint64_t(1) << stepLog2;
+}
+
+void Universe::checkpoint()
+{ checkpoint_ = root_; }
+
+void Universe::changesSinceCheckpoint(int width, int height,
+    std::vector<cell_storage::change_t>& changes)
+{
+    if (!checkpoint_) {
+        throw std::logic_error("There is no checkpoint.");
+    }
+    // оба корня с центром в (0, 0): меньший дорастает до большего
+    node_t from = *checkpoint_;
+    node_t to = root_;
+    while (nodes_[from].level < nodes_[to].level) from = grow_(from);
+    while (nodes_[to].level < nodes_[from].level) to = grow_(to);
+    coord_t h = side(nodes_[to].level - 1);
+    diff_(from, to, -h, -h, width, height, changes);
+}
+
+std::uint64_t Universe::population(owner_t owner,
+    coord_t x0, coord_t y0, coord_t x1, coord_t y1) const
+{
+    int color = colorOf_(owner);
+    if (!color) return 0;
+    return population_(root_, color, -half_(), -half_(), x0, y0, x1, y1);
+}
+
+std::uint64_t Universe::population() const noexcept
+{ return totalPop_(root_); }
+
+std::vector<owner_t> Universe::owners(
+    coord_t x0, coord_t y0, coord_t x1, coord_t y1) const
+{
+    std::vector<owner_t> res;
+    for (int color = 1; color <= maxColors; ++color) {
+        if (colorOwner_[color] &&
+            population_(root_, color, -half_(), -half_(), x0, y0, x1, y1))
+        {
+            res.push_back(colorOwner_[color]);
+        }
+    }
+    return res;
+}
+
+bool Universe::isDeterministic() const noexcept {
+    // рождение из пустоты не даёт ни владельца, ни конечного поля
+    if (birth_[0]) return false;
+    if (!colorOwner_[1] || !colorOwner_[2]) return true;
+    // при чётном количестве соседей двух цветов возможна ничья
+    for (int n = 2; n < static_cast<int>(birth_.size()); n += 2) {
+        if (birth_[n]) return false;
+    }
+    return true;
+}
+
+bool Universe::hasColor(owner_t owner) const noexcept
+{ return colorOf_(owner) != 0; }
+
+std::uint64_t Universe::generation() const noexcept
+{ return generation_; }
+
+std::size_t Universe::nodeCount() const noexcept
+{ return nodes_.size(); }
+
+Universe::node_t
+Universe::join_(node_t nw, node_t ne, node_t sw, node_t se) {
+    std::array<node_t, 4> key{ nw, ne, sw, se };
+    if (auto it = index_.find(key); it != index_.end()) {
+        return it->second;
+    }
+    Node node{ key, nodes_[nw].level + 1, {} };
+    for (auto c : key) {
+        for (int i = 0; i < maxColors; ++i) {
+            node.pop[i] += nodes_[c].pop[i];
+        }
+    }
+    node_t idx = static_cast<node_t>(nodes_.size());
+    nodes_.push_back(node);
+    index_.emplace(key, idx);
+    return idx;
+}
+
+Universe::node_t Universe::empty_(int level) {
+    while (static_cast<int>(empties_.size()) <= level) {
+        auto e = empties_.back();
+        empties_.push_back(join_(e, e, e, e));
+    }
+    return empties_[level];
+}
+
+Universe::node_t Universe::leaf_(int color) const noexcept
+{ return static_cast<node_t>(color); }
+
+std::uint64_t Universe::totalPop_(node_t node) const noexcept {
+    auto&& pop = nodes_[node].pop;
+    return pop[0] + pop[1];
+}
+
+int Universe::colorOf_(owner_t owner) const noexcept {
+    for (int color = 1; color <= maxColors; ++color) {
+        if (colorOwner_[color] == owner) return color;
+    }
+    return 0;
+}
+
+int Universe::addColor_(owner_t owner) {
+    for (int color = 1; color <= maxColors; ++color) {
+        if (!colorOwner_[color]) {
+            colorOwner_[color] = owner;
+            return color;
+        }
+    }
+    throw std::logic_error("Too many owners for the colored HashLife.");
+}
+
+coord_t Universe::half_() const noexcept
+{ return side(rootLevel_ - 1); }
+
+void Universe::expand_() {
+    root_ = grow_(root_);
+    ++rootLevel_;
+}
+
+Universe::node_t Universe::grow_(node_t node) {
+    auto [nw, ne, sw, se] = nodes_[node].child;
+    auto e = empty_(nodes_[node].level - 1);
+    return join_(
+        join_(e, e, e, nw),
+        join_(e, e, ne, e),
+        join_(e, sw, e, e),
+        join_(se, e, e, e));
+}
+
+bool Universe::isCentered_() const noexcept {
+    auto&& r = nodes_[root_].child;
+    auto pop = [this] (node_t node, int q) {
+        return totalPop_(nodes_[node].child[q]);
+    };
+    // все существа во внутренней половине корня
+    return !(pop(r[0], 0) || pop(r[0], 1) || pop(r[0], 2) ||
+             pop(r[1], 0) || pop(r[1], 1) || pop(r[1], 3) ||
+             pop(r[2], 0) || pop(r[2], 2) || pop(r[2], 3) ||
+             pop(r[3], 1) || pop(r[3], 2) || pop(r[3], 3));
+}
+
+Universe::node_t Universe::successor_(node_t node, int stepLog2) {
+    int level = nodes_[node].level;
+    if (!totalPop_(node)) {
+        return empty_(level - 1);
+    }
+    stepLog2 = std::min(stepLog2, level - 2);
+    std::uint64_t key = (std::uint64_t(node) << 8) | stepLog2;
+    if (auto it = results_.find(key); it != results_.end()) {
+        return it->second;
+    }
+
+    node_t res;
+    if (level == 2) {
+        res = life4x4_(node);
+    } else {
+        // внуки узла: g[y][x] на сетке 4x4
+        node_t g[4][4];
+        auto children = nodes_[node].child;
+        for (int q = 0; q < 4; ++q) {
+            auto sub = nodes_[children[q]].child;
+            for (int s = 0; s < 4; ++s) {
+                g[(q / 2) * 2 + s / 2][(q % 2) * 2 + s % 2] = sub[s];
+            }
+        }
+        // девять перекрывающихся подузлов, продвинутых на первую половину шага
+        node_t c[3][3];
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 3; ++x) {
+                c[y][x] = successor_(
+                    join_(g[y][x], g[y][x + 1], g[y + 1][x], g[y + 1][x + 1]),
+                    stepLog2);
+            }
+        }
+        node_t q[4];
+        for (int y = 0; y < 2; ++y) {
+            for (int x = 0; x < 2; ++x) {
+                if (stepLog2 < level - 2) {
+                    // шаг уже сделан: собрать центр из середин подузлов
+                    q[y * 2 + x] = join_(
+                        nodes_[c[y][x]].child[3],
+                        nodes_[c[y][x + 1]].child[2],
+                        nodes_[c[y + 1][x]].child[1],
+                        nodes_[c[y + 1][x + 1]].child[0]);
+                } else {
+                    q[y * 2 + x] = successor_(
+                        join_(c[y][x], c[y][x + 1],
+                              c[y + 1][x], c[y + 1][x + 1]),
+                        stepLog2);
+                }
+            }
+        }
+        res = join_(q[0], q[1], q[2], q[3]);
+    }
+    results_.emplace(key, res);
+    return res;
+}
+
+Universe::node_t Universe::life4x4_(node_t node) {
+    // цвета клеток узла 4x4
+    int g[4][4];
+    auto children = nodes_[node].child;
+    for (int q = 0; q < 4; ++q) {
+        auto sub = nodes_[children[q]].child;
+        for (int s = 0; s < 4; ++s) {
+            g[(q / 2) * 2 + s / 2][(q % 2) * 2 + s % 2] =
+                static_cast<int>(sub[s]);
+        }
+    }
+    node_t res[4];
+    for (int y = 1; y <= 2; ++y) {
+        for (int x = 1; x <= 2; ++x) {
+            std::array<int, maxColors + 1> count{};
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (dx || dy) ++count[g[y + dy][x + dx]];
+                }
+            }
+            int n = count[1] + count[2];
+            int color = g[y][x];
+            if (color) {
+                color = survive_[n] ? color : 0;
+            } else if (birth_[n]) {
+                if (count[1] == count[2]) {
+                    throw std::logic_error(
+                        "The rule is not supported by the colored HashLife.");
+                }
+                color = count[1] > count[2] ? 1 : 2;
+            }
+            res[(y - 1) * 2 + (x - 1)] = leaf_(color);
+        }
+    }
+    return join_(res[0], res[1], res[2], res[3]);
+}
+
+Universe::node_t
+Universe::set_(node_t node, coord_t xidx, coord_t yidx, int color) {
+    int level = nodes_[node].level;
+    if (!level) {
+        return leaf_(color);
+    }
+    coord_t h = side(level - 1);
+    int q = (xidx >= h) + 2 * (yidx >= h);
+    auto child = nodes_[node].child;
+    child[q] = set_(child[q], xidx % h, yidx % h, color);
+    return join_(child[0], child[1], child[2], child[3]);
+}
+
+Universe::node_t Universe::build_(int level, coord_t xidx, coord_t yidx,
+    int width, int height, const std::vector<owner_t>& cells)
+{
+    if (xidx >= width || yidx >= height) {
+        return empty_(level);
+    }
+    if (!level) {
+        auto own = cells[static_cast<std::size_t>(yidx) * width + xidx];
+        return leaf_(own == cell_storage::emptyOwner ? 0 : colorOf_(own));
+    }
+    coord_t h = side(level - 1);
+    return join_(
+        build_(level - 1, xidx, yidx, width, height, cells),
+        build_(level - 1, xidx + h, yidx, width, height, cells),
+        build_(level - 1, xidx, yidx + h, width, height, cells),
+        build_(level - 1, xidx + h, yidx + h, width, height, cells));
+}
+
+void Universe::store_(node_t node, coord_t xidx, coord_t yidx,
+    int width, int height, std::vector<owner_t>& cells) const
+{
+    int level = nodes_[node].level;
+    coord_t s = side(level);
+    if (!totalPop_(node) ||
+        xidx >= width || yidx >= height ||
+        xidx + s <= 0 || yidx + s <= 0)
+    {
+        return;
+    }
+    if (!level) {
+        cells[static_cast<std::size_t>(yidx) * width + xidx] =
+            colorOwner_[node];
+        return;
+    }
+    coord_t h = s / 2;
+    auto&& child = nodes_[node].child;
+    store_(child[0], xidx, yidx, width, height, cells);
+    store_(child[1], xidx + h, yidx, width, height, cells);
+    store_(child[2], xidx, yidx + h, width, height, cells);
+    store_(child[3], xidx + h, yidx + h, width, height, cells);
+}
+
+Universe::node_t Universe::clip_(node_t node, coord_t xidx, coord_t yidx,
+    coord_t x0, coord_t y0, coord_t x1, coord_t y1)
+{
+    int level = nodes_[node].level;
+    coord_t s = side(level);
+    if (!totalPop_(node) ||
+        (xidx >= x0 && yidx >= y0 && xidx + s <= x1 && yidx + s <= y1))
+    {
+        return node;
+    }
+    if (xidx >= x1 || yidx >= y1 || xidx + s <= x0 || yidx + s <= y0) {
+        return empty_(level);
+    }
+    coord_t h = s / 2;
+    auto child = nodes_[node].child;
+    return join_(
+        clip_(child[0], xidx, yidx, x0, y0, x1, y1),
+        clip_(child[1], xidx + h, yidx, x0, y0, x1, y1),
+        clip_(child[2], xidx, yidx + h, x0, y0, x1, y1),
+        clip_(child[3], xidx + h, yidx + h, x0, y0, x1, y1));
+}
+
+std::uint64_t Universe::population_(node_t node, int color,
+    coord_t xidx, coord_t yidx,
+    coord_t x0, coord_t y0, coord_t x1, coord_t y1) const
+{
+    auto&& n = nodes_[node];
+    coord_t s = side(n.level);
+    if (!n.pop[color - 1] ||
+        xidx >= x1 || yidx >= y1 || xidx + s <= x0 || yidx + s <= y0)
+    {
+        return 0;
+    }
+    if (xidx >= x0 && yidx >= y0 && xidx + s <= x1 && yidx + s <= y1) {
+        return n.pop[color - 1];
+    }
+    coord_t h = s / 2;
+    return population_(n.child[0], color, xidx, yidx, x0, y0, x1, y1)
+         + population_(n.child[1], color, xidx + h, yidx, x0, y0, x1, y1)
+         + population_(n.child[2], color, xidx, yidx + h, x0, y0, x1, y1)
+         + population_(n.child[3], color, xidx + h, yidx + h, x0, y0, x1, y1);
+}
+
+void Universe::diff_(node_t from, node_t to, coord_t xidx, coord_t yidx,
+    int width, int height,
+    std::vector<cell_storage::change_t>& changes) const
+{
+    // одинаковые поддеревья - один узел
+    if (from == to) return;
+    int level = nodes_[to].level;
+    coord_t s = side(level);
+    if (xidx >= width || yidx >= height || xidx + s <= 0 || yidx + s <= 0) {
+        return;
+    }
+    if (!level) {
+        changes.emplace_back(static_cast<int>(xidx), static_cast<int>(yidx),
+                             colorOwner_[to]);
+        return;
+    }
+    coord_t h = s / 2;
+    auto&& f = nodes_[from].child;
+    auto&& t = nodes_[to].child;
+    diff_(f[0], t[0], xidx, yidx, width, height, changes);
+    diff_(f[1], t[1], xidx + h, yidx, width, height, changes);
+    diff_(f[2], t[2], xidx, yidx + h, width, height, changes);
+    diff_(f[3], t[3], xidx + h, yidx + h, width, height, changes);
+}
+
+void Universe::collectGarbage_() {
+    // оставить только узлы, достижимые из корня и запомненного корня
+    std::vector<Node> nodes(nodes_.begin(), nodes_.begin() + maxColors + 1);
+    std::unordered_map<node_t, node_t> remap;
+    root_ = copyReachable_(root_, nodes, remap);
+    if (checkpoint_) {
+        checkpoint_ = copyReachable_(*checkpoint_, nodes, remap);
+    }
+    nodes_ = std::move(nodes);
+    index_.clear();
+    for (node_t i = maxColors + 1; i < nodes_.size(); ++i) {
+        index_.emplace(nodes_[i].child, i);
+    }
+    results_.clear();
+    empties_.assign(1, leaf_(0));
+}
+
+Universe::node_t Universe::copyReachable_(node_t node,
+    std::vector<Node>& nodes,
+    std::unordered_map<node_t, node_t>& remap) const
+{
+    if (node <= maxColors) return node;
+    if (auto it = remap.find(node); it != remap.end()) {
+        return it->second;
+    }
+    Node copy = nodes_[node];
+    for (auto&& c : copy.child) {
+        c = copyReachable_(c, nodes, remap);
+    }
+    node_t idx = static_cast<node_t>(nodes.size());
+    nodes.push_back(copy);
+    remap.emplace(node, idx);
+    return idx;
+}
+
+} // namespace hashlife
@@ -0,0 +1,197 @@
+#include "hashlife_engine.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "player.hpp"
+
+namespace game_engine {
+
+HashLifeGameEngine::HashLifeGameEngine(
+    std::shared_ptr<GameFieldWithFigure> field,
+    std::unique_ptr<IGameEngine> fallback,
+    int stepLog2) :
+    field_(field)
+    , fallback_(std::move(fallback))
+    , stepLog2_(stepLog2)
+{}
+
+void HashLifeGameEngine::computeEr(
+    game_field_area::IGameFieldArea& area,
+    const TransitionTable& rule,
+    const counter_rng::CounterRng& rng)
+{
+    // поддерживаются только поля без ничьих, генератор нужен запасному
+    if (!isSupported(rule)) {
+        universe_.reset();
+        if (!fallback_) {
+            throw std::logic_error(
+                "The field is not supported by the HashLife engine.");
+        }
+        fallback_->computeEr(area, rule, rng);
+        return;
+    }
+
+    syncUniverse_();
+    universe_->checkpoint();
+    advance_();
+    applyChanges_(area);
+}
+
+bool HashLifeGameEngine::isSupported(const TransitionTable& rule) {
+    loadRule_(rule);
+    if (!isFieldSupported_() || birth_[0]) {
+        return false;
+    }
+    // количество существ поддерживается полем, клетки не обходятся
+    auto&& population = field_->population();
+    int owners = 0;
+    for (int own = 1; own < static_cast<int>(population.size()); ++own) {
+        if (population[own]) ++owners;
+    }
+    if (owners > hashlife::Universe::maxColors) {
+        return false;
+    }
+    // у двух игроков ничья возможна при чётном количестве соседей
+    if (owners == hashlife::Universe::maxColors) {
+        for (int n = 2; n < static_cast<int>(birth_.size()); n += 2) {
+            if (birth_[n]) return false;
+        }
+    }
+    return true;
+}
+
+const hashlife::Universe* HashLifeGameEngine::universe() const noexcept
+{ return universe_ ? &*universe_ : nullptr; }
+
+std::vector<cell_storage::owner_t> HashLifeGameEngine::ownersInArea(
+    const game_field_area::IGameFieldArea& area) const
+{
+    if (!universe_) {
+        throw std::logic_error("The HashLife engine has not made a step.");
+    }
+    auto [x0, y0] = area.upperLeftCorner();
+    auto [x1, y1] = area.lowerRightCorner();
+    return universe_->owners(x0, y0, x1 + 1, y1 + 1);
+}
+
+void HashLifeGameEngine::loadRule_(const TransitionTable& rule) {
+    for (int n = 0; n < static_cast<int>(birth_.size()); ++n) {
+        birth_[n] = rule.birth(n);
+        survive_[n] = rule.survive(n);
+    }
+}
+
+bool HashLifeGameEngine::isFieldSupported_() {
+    // тор и дополнительные соседи нарушают однородность правила
+    if (field_->topology() != topology::topology_t::BOUNDED || 
+        !field_->cellsWithExtraNeighbors().empty()) 
+    {
+        return false;
+    }
+    // исключённые фигурой клетки нарушают однородность поля
+    return field_->figureMask().isFull();
+}
+
+void HashLifeGameEngine::syncUniverse_() {
+    bool sameRule = universe_ && universeBirth_ == birth_ &&
+                    universeSurvive_ == survive_;
+    if (sameRule && universeVersion_ == field_->version()) {
+        return;
+    }
+    // дерево с прежним правилом и цветами сохраняет запомненные
+    // результаты, новое нужно для нового правила или владельца
+    auto&& population = field_->population();
+    bool knowsOwners = sameRule;
+    for (int own = 1; knowsOwners && own < static_cast<int>(population.size()); 
+         ++own) 
+    {
+        if (population[own] && !universe_->hasColor(own)) {
+            knowsOwners = false;
+        }
+    }
+    if (!knowsOwners) {
+        universe_.emplace(birth_, survive_);
+        universeBirth_ = birth_;
+        universeSurvive_ = survive_;
+    }
+    loadCells_();
+    universe_->load(field_->width(), field_->height(), cells_);
+    universeVersion_ = field_->version();
+}
+
+void HashLifeGameEngine::loadCells_() {
+    auto&& storage = field_->storage();
+    int w = field_->width();
+    int h = field_->height();
+    cells_.resize(static_cast<std::size_t>(w) * h);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            cells_[static_cast<std::size_t>(y) * w + x] = storage.owner(x, y);
+        }
+    }
+}
+
+void HashLifeGameEngine::advance_() {
+    int w = field_->width();
+    int h = field_->height();
+    // 2^stepLog2 поколений набираются самыми длинными прыжками, 
+    // после которых существа остаются на поле; у края поколения
+    // считаются по одному с обрезкой по полю
+    std::uint64_t remained = std::uint64_t(1) << stepLog2_;
+    while (remained) {
+        int jump = std::bit_width(remained) - 1;
+        while (jump >= 0 && !staysInside_(jump)) --jump;
+        if (jump >= 0) {
+            universe_->step(jump);
+            remained -= std::uint64_t(1) << jump;
+        } else {
+            universe_->step(0);
+            universe_->clip(0, 0, w, h);
+            --remained;
+        }
+    }
+}
+
+bool HashLifeGameEngine::staysInside_(int stepLog2) const {
+    int w = field_->width();
+    int h = field_->height();
+    // за 2^stepLog2 поколений существа уходят от края не дальше этого
+    hashlife::coord_t ring = (hashlife::coord_t(1) << stepLog2) + 1;
+    if (ring * 2 >= w || ring * 2 >= h) {
+        return false;
+    }
+    std::uint64_t innerPop = 0;
+    for (auto own : universe_->owners(0, 0, w, h)) {
+        innerPop += universe_->population(
+            own, ring, ring, w - ring, h - ring);
+    }
+    return innerPop == universe_->population();
+}
+
+void HashLifeGameEngine::applyChanges_(
+    game_field_area::IGameFieldArea& area)
+{
+    // обходятся только изменившиеся поддеревья
+    universe_->changesSinceCheckpoint(
+        field_->width(), field_->height(), changes_);
+    std::sort(changes_.begin(), changes_.end(),
+        [] (auto&& l, auto&& r) {
+            return std::tie(std::get<1>(l), std::get<0>(l)) <
+                   std::tie(std::get<1>(r), std::get<0>(r));
+        });
+    // клетки вне зоны не меняются: дерево возвращается к полю
+    auto&& storage = field_->storage();
+    std::erase_if(changes_, [&] (auto&& ch) {
+        auto [x, y, own] = ch;
+        if (area.isCellAvailable(x, y)) return false;
+        universe_->setCell(x, y, storage.owner(x, y));
+        return true;
+    });
+    area.applyChanges(changes_);
+    changes_.clear();
+    universeVersion_ = field_->version();
+}
+
+} // namespace game_engine
@@ -24,6 +24,7 @@ int main() try {
     using namespace game_event;
     using namespace figure;
     using namespace creature_strategy;
+    using namespace cell_storage;
     
     constexpr float k = 0.8f;
 
@@ -47,8 +48,13 @@ int main() try {
     // ###########################################################################
     auto creatFactory = 
         std::make_unique<CreatureFactory>();
-    auto cellFactory =
-        std::make_unique<CellFactory>();
+    auto cellStorage = 
+#if 0
+        std::make_unique<CellObjectStorage>(
+            std::make_unique<CellFactory>());
+#else
+        std::make_unique<FlatCellStorage>();
+#endif
     
     float w = fieldWidth;
     float h = fieldHeight;
@@ -69,8 +75,9 @@ int main() try {
     >(
                     fieldWidth, fieldHeight, 
                     std::move(creatFactory),
-                    std::move(cellFactory),
-                    std::move(figure)
+                    std::move(cellStorage),
+                    std::move(figure),
+                    topology::topology_t::TORUS
                 );
     // ###########################################################################
 
@@ -156,6 +163,7 @@ int main() try {
         {1, sf::Color::Blue} 
     };
 
+    auto snapshots = std::make_shared<field_snapshot::SnapshotPublisher>(*field);
     auto controllerArea = 
         std::make_unique<GameFieldWithFigureArea>(field, ul, lr);
     controllerArea->unlock();
@@ -164,43 +172,21 @@ int main() try {
         model,  stackL, 
         input, window, 
         crColors,
-        field
+        snapshots
     );
     // ###########################################################################
 
     
-    // configuring the subject-observer interaction //
+    // configuring the event subscriptions //
     /////////////////////////////////////////////////////////////////
 
-    // controller
-    field->attach(controller, 
-        static_cast<int>(event_t::FIELD_CLEAR));
-    field->attach(controller, 
-        static_cast<int>(event_t::CREATURE_REMOVE_IN_FIELD));
-    field->attach(controller, 
-        static_cast<int>(event_t::CREATURE_SET_IN_FIELD));
-    model->attach(controller, 
-        static_cast<int>(event_t::PLAYER_BETS_CREATURES));
-    model->attach(controller,
-        static_cast<int>(event_t::GAME_MODEL_CALCULATED_ER));
-    model->attach(controller,
-        static_cast<int>(event_t::WINNER_DETERMINATE));
-    model->attach(controller,
-        static_cast<int>(event_t::DRAW_DETERMINATE));
-    model->attach(controller,
-        static_cast<int>(event_t::USER_INPUT_REQUIRED));
-    input->attach(controller, 
-        static_cast<int>(event_t::USER_ASKED_SET_CREATURE));
-
-    // model
-    input->attach(model, 
-        static_cast<int>(event_t::USER_ASKED_CLOSE));
-    input->attach(model, 
-        static_cast<int>(event_t::USER_ASKED_RESTART));
-    field->attach(model, 
-        static_cast<int>(event_t::CREATURE_REMOVE_IN_FIELD));
-    field->attach(model, 
-        static_cast<int>(event_t::CREATURE_SET_IN_FIELD));
+    // each handler is bound to the events it has on() overloads for.
+    // the model runs on its own thread: field changes reach the
+    // controller as snapshots, model events and input go through queues
+    field->events().subscribe(snapshots);
+    field->events().subscribe(model);
+    model->events().subscribe(controller->modelEvents());
+    input->events().subscribe(model->inbox());
     /////////////////////////////////////////////////////////////////
 
     controller->game();
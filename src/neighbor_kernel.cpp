@@ -0,0 +1,170 @@
+#include "neighbor_kernel.hpp"
+
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    defined(__i386__) || defined(_M_IX86)
+#define NEIGHBOR_KERNEL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+    using neighbor_kernel::kernel_t;
+
+    using row_kernel_t = void (*)(
+        const std::uint8_t*, const std::uint8_t*, const std::uint8_t*,
+        std::uint8_t*, int, int);
+
+    // досчитать клетки [from, width) без векторных инструкций
+    void sumRowScalar(
+        const std::uint8_t* a, const std::uint8_t* r, const std::uint8_t* b,
+        std::uint8_t* out, int from, int width)
+    {
+        for (int x = from; x < width; ++x) {
+            out[x] = a[x - 1] + a[x] + a[x + 1]
+                   + r[x - 1]        + r[x + 1]
+                   + b[x - 1] + b[x] + b[x + 1];
+        }
+    }
+
+#ifdef NEIGHBOR_KERNEL_X86
+    TARGET_SSE2 inline __m128i load(const std::uint8_t* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    TARGET_AVX2 inline __m256i load256(const std::uint8_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    TARGET_SSE2 void sumRowSse2(
+        const std::uint8_t* a, const std::uint8_t* r, const std::uint8_t* b,
+        std::uint8_t* out, int from, int width)
+    {
+        int x = from;
+        for (; x + 16 <= width; x += 16) {
+            // сумма не больше 8, поэтому переполнения байта нет
+            __m128i s = _mm_add_epi8(load(a + x - 1), load(a + x));
+            s = _mm_add_epi8(s, load(a + x + 1));
+            s = _mm_add_epi8(s, load(r + x - 1));
+            s = _mm_add_epi8(s, load(r + x + 1));
+            s = _mm_add_epi8(s, load(b + x - 1));
+            s = _mm_add_epi8(s, load(b + x));
+            s = _mm_add_epi8(s, load(b + x + 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), s);
+        }
+        sumRowScalar(a, r, b, out, x, width);
+    }
+
+    TARGET_AVX2 void sumRowAvx2(
+        const std::uint8_t* a, const std::uint8_t* r, const std::uint8_t* b,
+        std::uint8_t* out, int from, int width)
+    {
+        int x = from;
+        for (; x + 32 <= width; x += 32) {
+            __m256i s = _mm256_add_epi8(load256(a + x - 1), load256(a + x));
+            s = _mm256_add_epi8(s, load256(a + x + 1));
+            s = _mm256_add_epi8(s, load256(r + x - 1));
+            s = _mm256_add_epi8(s, load256(r + x + 1));
+            s = _mm256_add_epi8(s, load256(b + x - 1));
+            s = _mm256_add_epi8(s, load256(b + x));
+            s = _mm256_add_epi8(s, load256(b + x + 1));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), s);
+        }
+        sumRowSse2(a, r, b, out, x, width);
+    }
+
+    bool cpuSupportsAvx2() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuidex(info, 0, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        // процессор и ОС должны поддерживать AVX (OSXSAVE + AVX)
+        bool osxsave = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return info[1] & (1 << 5);
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    bool cpuSupportsSse2() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+        return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        return info[3] & (1 << 26);
+#else
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+#endif // NEIGHBOR_KERNEL_X86
+
+    kernel_t detectKernel() noexcept {
+#ifdef NEIGHBOR_KERNEL_X86
+        if (cpuSupportsAvx2()) return kernel_t::AVX2;
+        if (cpuSupportsSse2()) return kernel_t::SSE2;
+#endif
+        return kernel_t::SCALAR;
+    }
+
+    row_kernel_t kernelFunction(kernel_t kernel) {
+        switch (kernel) {
+#ifdef NEIGHBOR_KERNEL_X86
+            case kernel_t::AVX2: return sumRowAvx2;
+            case kernel_t::SSE2: return sumRowSse2;
+#endif
+            default: return sumRowScalar;
+        }
+    }
+
+} // namespace
+
+namespace neighbor_kernel {
+
+kernel_t activeKernel() noexcept {
+    static const kernel_t kernel = detectKernel();
+    return kernel;
+}
+
+bool isKernelSupported(kernel_t kernel) noexcept {
+    return static_cast<int>(kernel) <= static_cast<int>(activeKernel());
+}
+
+void sumRowNeighbors(
+    const std::uint8_t* above,
+    const std::uint8_t* row,
+    const std::uint8_t* below,
+    std::uint8_t* out,
+    int width)
+{
+    static const row_kernel_t kernel = kernelFunction(activeKernel());
+    kernel(above, row, below, out, 0, width);
+}
+
+void sumRowNeighbors(
+    kernel_t kernel,
+    const std::uint8_t* above,
+    const std::uint8_t* row,
+    const std::uint8_t* below,
+    std::uint8_t* out,
+    int width)
+{
+    if (!isKernelSupported(kernel)) {
+        throw std::logic_error(
+            "The neighbor kernel is not supported by the CPU");
+    }
+    kernelFunction(kernel)(above, row, below, out, 0, width);
+}
+
+} // namespace neighbor_kernel
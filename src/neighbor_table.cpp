@@ -0,0 +1,100 @@
+#include "neighbor_table.hpp"
+
+#include <stdexcept>
+
+namespace neighbor_table {
+
+NeighborTable::NeighborTable(
+    int width, int height,
+    std::vector<std::uint32_t> offsets,
+    std::vector<std::uint32_t> indices) :
+    width_(width)
+    , height_(height)
+    , offsets_(std::move(offsets))
+    , indices_(std::move(indices))
+{
+    if (offsets_.size() != static_cast<std::size_t>(width_) * height_ + 1 ||
+        offsets_.back() != indices_.size())
+    {
+        throw std::logic_error("Inconsistent neighbor table.");
+    }
+}
+
+NeighborTable NeighborTable::withLinks(
+    const std::map<std::pair<int, int>, std::pair<int, int>>& links) const
+{
+    std::map<std::uint32_t, std::uint32_t> linked;
+    for (auto&& [cell, ne] : links) {
+        linked[index(cell.first, cell.second)] = index(ne.first, ne.second);
+    }
+
+    std::vector<std::uint32_t> offsets{0};
+    std::vector<std::uint32_t> indices;
+    offsets.reserve(offsets_.size());
+    indices.reserve(indices_.size());
+    for (std::uint32_t i = 0; i + 1 < offsets_.size(); ++i) {
+        auto ne = neighbors(i);
+        indices.insert(indices.end(), ne.begin(), ne.end());
+        if (auto it = linked.find(i); it != linked.end()) {
+            auto add = neighbors(it->second);
+            indices.insert(indices.end(), add.begin(), add.end());
+        }
+        offsets.push_back(indices.size());
+    }
+
+    NeighborTable res(width_, height_, std::move(offsets), std::move(indices));
+    res.linkedCells_ = linkedCells_;
+    for (auto&& [cell, ne] : linked) {
+        res.linkedCells_.push_back(cell);
+    }
+    return res;
+}
+
+NeighborTable NeighborTable::transposed() const {
+    // посчитать для каждой клетки, у скольких клеток она соседка
+    std::vector<std::uint32_t> offsets(offsets_.size(), 0);
+    for (auto ne : indices_) {
+        ++offsets[ne + 1];
+    }
+    for (std::size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+    std::vector<std::uint32_t> indices(indices_.size());
+    auto pos = offsets;
+    for (std::uint32_t i = 0; i + 1 < offsets_.size(); ++i) {
+        for (auto ne : neighbors(i)) {
+            indices[pos[ne]++] = i;
+        }
+    }
+    return NeighborTable(
+        width_, height_, std::move(offsets), std::move(indices));
+}
+
+std::span<const std::uint32_t>
+NeighborTable::neighbors(std::uint32_t cell) const noexcept {
+    return { indices_.data() + offsets_[cell],
+             indices_.data() + offsets_[cell + 1] };
+}
+
+std::uint32_t NeighborTable::index(int xidx, int yidx) const noexcept
+{ return static_cast<std::uint32_t>(yidx) * width_ + xidx; }
+
+const std::vector<std::uint32_t>&
+NeighborTable::linkedCells() const noexcept
+{ return linkedCells_; }
+
+const std::vector<std::uint32_t>&
+NeighborTable::offsets() const noexcept
+{ return offsets_; }
+
+const std::vector<std::uint32_t>&
+NeighborTable::indices() const noexcept
+{ return indices_; }
+
+int NeighborTable::width() const noexcept
+{ return width_; }
+
+int NeighborTable::height() const noexcept
+{ return height_; }
+
+} // namespace neighbor_table
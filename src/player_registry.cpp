@@ -0,0 +1,51 @@
+#include "player_registry.hpp"
+
+#include <stdexcept>
+
+#include "player.hpp"
+
+namespace player {
+
+cell_storage::owner_t PlayerRegistry::registerPlayer(
+    std::shared_ptr<Player> player,
+    const factory::ICreatureFactory& creatFactory)
+{
+    auto own = ownerOf(*player);
+    auto&& creat = creatures_[own];
+    if (!creat) {
+        creat = creatFactory.createCreature(player);
+    } else if (creat->player() != player) {
+        throw std::logic_error(
+            "Another player with the same id is registered.");
+    }
+    return own;
+}
+
+bool PlayerRegistry::contains(owner_t owner) const noexcept {
+    return owner < creatures_.size() && creatures_[owner];
+}
+
+std::shared_ptr<Player> PlayerRegistry::player(owner_t owner) const {
+    if (!contains(owner)) {
+        return nullptr;
+    }
+    return creatures_[owner]->player();
+}
+
+const creature::ICreature& 
+PlayerRegistry::creature(owner_t owner) const {
+    if (!contains(owner)) {
+        throw std::logic_error("There is no creature in the cell.");
+    }
+    return *creatures_[owner];
+}
+
+cell_storage::owner_t PlayerRegistry::ownerOf(const Player& player) {
+    int id = player.id();
+    if (id < 0 || id >= cell_storage::maxPlayers) {
+        throw std::out_of_range("Player id is out of range.");
+    }
+    return static_cast<owner_t>(id + 1);
+}
+
+} // namespace player
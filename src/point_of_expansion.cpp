@@ -9,43 +9,35 @@ GamefieldWithFigureAndTriangularNeighbors(
     int width, int height, 
     std::unique_ptr<factory::ICreatureFactory> creatFactory,
     std::unique_ptr<factory::ICellFactory> cellFactory,
-    std::unique_ptr<figure::IFigure> figure):
+    std::unique_ptr<figure::IFigure> figure,
+    topology::topology_t topology):
     GameFieldWithFigure(width, height, 
                         std::move(creatFactory), 
                         std::move(cellFactory),
-                        std::move(figure))
-{ computeAddNeighbors_(); }
+                        std::move(figure),
+                        topology)
+{ 
+    computeAddNeighbors_(); 
+    linkNeighbors_(addNeighbor_);
+}
 
-std::map<const std::shared_ptr<player::Player>, int> 
 GamefieldWithFigureAndTriangularNeighbors::
-countCellNeighborsCreatures(int xidx, int yidx) const {
-    using base = GameFieldWithFigure;
-
-    auto curCount =
-         base::countCellNeighborsCreatures(
-            xidx, yidx);
-    
-    std::pair<int, int> cur{xidx, yidx};
-    // если мы в угле и клека доступна
-    if (addNeighbor_.contains(cur)) {   
-        // то получить и сложить с текущеми соседями
-        auto [nex, ney] = addNeighbor_.at(cur);
-        auto neCount = 
-            base::countCellNeighborsCreatures(nex, ney);
-        for (auto&& [p, c] : neCount) {
-            auto it = curCount.find(p);
-            if (it != curCount.end()) {
-                it->second += c; 
-            } else {
-                curCount[p] = c;
-            }
-        }
-    }
-
-    return curCount;
+GamefieldWithFigureAndTriangularNeighbors(
+    int width, int height, 
+    std::unique_ptr<factory::ICreatureFactory> creatFactory,
+    std::unique_ptr<cell_storage::ICellStorage> storage,
+    std::unique_ptr<figure::IFigure> figure,
+    topology::topology_t topology):
+    GameFieldWithFigure(width, height, 
+                        std::move(creatFactory), 
+                        std::move(storage),
+                        std::move(figure),
+                        topology)
+{ 
+    computeAddNeighbors_(); 
+    linkNeighbors_(addNeighbor_);
 }
 
-
 void 
 GamefieldWithFigureAndTriangularNeighbors::
 computeAddNeighbors_() {
@@ -0,0 +1,153 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace thread_pool {
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount < 1) {
+        throw std::invalid_argument("Thread count must be positive.");
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        queues_.emplace_back(std::make_unique<WorkerQueue>());
+    }
+    stats_.resize(threadCount);
+    finish_.resize(threadCount);
+    for (int i = 1; i < threadCount; ++i) {
+        workers_.emplace_back([this, i] { workerLoop_(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto&& w : workers_) {
+        w.join();
+    }
+}
+
+void ThreadPool::parallelFor(
+    int taskCount, const std::function<void(int, int)>& task)
+{
+    if (workers_.empty() || taskCount <= 1) {
+        for (int i = 0; i < taskCount; ++i) {
+            task(i, 0);
+        }
+        stats_[0].tasks += std::max(taskCount, 0);
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        // соседние задачи достаются одному потоку
+        int threads = threadCount();
+        for (int w = 0; w < threads; ++w) {
+            std::lock_guard queueLock(queues_[w]->mutex);
+            for (int i = taskCount * w / threads; 
+                 i < taskCount * (w + 1) / threads; ++i)
+            {
+                queues_[w]->tasks.push_back(i);
+            }
+        }
+        task_ = &task;
+        busy_ = static_cast<int>(workers_.size());
+        error_ = nullptr;
+        ++job_;
+    }
+    wake_.notify_all();
+    runTasks_(0);
+
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    auto end = std::chrono::steady_clock::now();
+    for (int w = 0; w < threadCount(); ++w) {
+        stats_[w].idle += end - finish_[w];
+    }
+    task_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+int ThreadPool::threadCount() const noexcept
+{ return static_cast<int>(workers_.size()) + 1; }
+
+ThreadPool::Stats ThreadPool::stats() const {
+    Stats res;
+    for (auto&& s : stats_) {
+        res.tasks += s.tasks;
+        res.steals += s.steals;
+        res.idle += s.idle;
+    }
+    return res;
+}
+
+const std::vector<ThreadPool::Stats>& 
+ThreadPool::workerStats() const noexcept
+{ return stats_; }
+
+void ThreadPool::resetStats() noexcept {
+    for (auto&& s : stats_) {
+        s = Stats();
+    }
+}
+
+void ThreadPool::workerLoop_(int worker) {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || job_ != seen; });
+            if (stop_) return;
+            seen = job_;
+        }
+        runTasks_(worker);
+        {
+            std::lock_guard lock(mutex_);
+            if (--busy_ == 0) done_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runTasks_(int worker) {
+    int task;
+    // новые задачи не появляются: пустые очереди значат конец цикла
+    while (popOwn_(worker, task) || steal_(worker, task)) {
+        try {
+            (*task_)(task, worker);
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        ++stats_[worker].tasks;
+    }
+    finish_[worker] = std::chrono::steady_clock::now();
+}
+
+bool ThreadPool::popOwn_(int worker, int& task) {
+    auto&& queue = *queues_[worker];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal_(int worker, int& task) {
+    int threads = threadCount();
+    for (int k = 1; k < threads; ++k) {
+        auto&& queue = *queues_[(worker + k) % threads];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        ++stats_[worker].steals;
+        return true;
+    }
+    return false;
+}
+
+} // namespace thread_pool
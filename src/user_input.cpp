@@ -42,19 +42,14 @@ void UserInput::readInput() {
     }
 }
 
-void UserInput::attach(std::shared_ptr<observer::IObserver> obs, int event_t) 
-{ subject::ISubject::attach(obs, event_t); }
-
-void UserInput::detach(std::weak_ptr<observer::IObserver> obs, int event_t) 
-{ subject::ISubject::detach(obs, event_t); }
-
-void UserInput::notify(int event_t) 
-{ subject::ISubject::notify(event_t); }
-
 std::tuple<bool, int, int> UserInput::lastCoordInput() noexcept {
     return lastCoordInput_;
 }
 
+game_event::InputBus& UserInput::events() noexcept {
+    return events_;
+}
+
 void UserInput::computeCoord_(int x, int y) {
     int col = 
         (x - startX_) / (cellWidth_ + gridThickness_);
@@ -69,21 +64,18 @@ void UserInput::computeCoord_(int x, int y) {
 }
 
 void UserInput::fireUserAskedClose_() {
-    int evt = static_cast<int>(
-        game_event::event_t::USER_ASKED_CLOSE);
-    notify(evt);
+    events_.publish(game_event::UserAskedClose{});
 } 
 
 void UserInput::fireUserAskedSetCreature_() {
-    int evt = static_cast<int>(
-        game_event::event_t::USER_ASKED_SET_CREATURE);
-    notify(evt);
+    // координаты вне сетки не передаются
+    if (auto [suc, x, y] = lastCoordInput_; suc) {
+        events_.publish(game_event::UserAskedSetCreature{ x, y });
+    }
 }
 
 void UserInput::fireUserAskedRestart_() {
-    int evt = static_cast<int>(
-        game_event::event_t::USER_ASKED_RESTART);
-    notify(evt);
+    events_.publish(game_event::UserAskedRestart{});
 }
 
 } // namespace user_input
\ No newline at end of file
@@ -1,6 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <random>
+#include <thread>
+
 #include "game_model.hpp"
+#include "point_of_expansion.hpp"
+#include "bitboard_engine.hpp"
+#include "byte_grid_engine.hpp"
+#include "neighbor_kernel.hpp"
+#include "hashlife_engine.hpp"
+#include "stencil_engine.hpp"
+#include "figure_mask.hpp"
+#include "field_snapshot.hpp"
 
 namespace {
     bool eqFields(std::shared_ptr<game_field::IGameField> a, 
@@ -27,6 +38,36 @@ namespace {
         }
         return true;
     }
+
+    // сравнить поля с фигурой, пропуская исключённые клетки
+    bool eqFieldsInFigure(
+        std::shared_ptr<game_field::GameFieldWithFigure> a, 
+        std::shared_ptr<game_field::GameFieldWithFigure> b)
+    {   
+        if (a->width() != b->width() || 
+            a->height() != b->height()) return false;
+        for (int y = 0; y < a->height(); ++y) {
+            for (int x = 0; x < a->width(); ++x) {
+                if (a->isExcludedCell(x, y)) {
+                    continue;
+                }
+                if (a->hasCreatureInCell(x, y) != 
+                    b->hasCreatureInCell(x, y))
+                {
+                    return false;
+                }
+                if (!a->hasCreatureInCell(x, y)) {
+                    continue;
+                }
+                auto&& crA = a->getCreatureByCell(x, y);
+                auto&& crB = b->getCreatureByCell(x, y);
+                if (crA.player() != crB.player()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
 }
 
 // #################################################################################################
@@ -1328,32 +1369,33 @@ TEST(GameModelTest, UpdateOnDrawThenCloseGame) {
     using namespace game_model;
     using namespace creature_strategy;
 
-    using evt_t = game_event::event_t;
+    enum class seen_t { CHANGES_APPLIED, DRAW_DETERMINED, WINNER_DETERMINED };
 
-    struct SessionObserver : observer::IObserver {   
+    struct SessionObserver {   
         SessionObserver(std::shared_ptr<GameModel> model):
             model_(model)
         {}
 
-        void update(int event_t) override {
-            evt_.push_back(static_cast<evt_t>(event_t));
-            
-            switch (evt_.back()) {
-                case evt_t::DRAW_DETERMINATE:
-                    update_ = true;
-                    break;
-                case evt_t::CREATURE_REMOVE_IN_FIELD:
-                    ++creatRemoveCount_;
-                    break;
-                default: 
-                    unexpected_ = true;
-            }
+        void on(const game_event::ChangesApplied&) {
+            evt_.push_back(seen_t::CHANGES_APPLIED);
+            ++creatRemoveCount_;
+            model_->on(game_event::UserAskedClose{});
+        }
 
-            model_->update(static_cast<int>(evt_t::USER_ASKED_CLOSE));
+        void on(const game_event::DrawDetermined&) {
+            evt_.push_back(seen_t::DRAW_DETERMINED);
+            update_ = true;
+            model_->on(game_event::UserAskedClose{});
+        }
+
+        void on(const game_event::WinnerDetermined&) {
+            evt_.push_back(seen_t::WINNER_DETERMINED);
+            unexpected_ = true;
+            model_->on(game_event::UserAskedClose{});
         }
 
         std::shared_ptr<GameModel> model_;
-        std::vector<evt_t> evt_;
+        std::vector<seen_t> evt_;
         bool update_ = false;
         bool unexpected_ = false;
         int creatRemoveCount_ = 0;
@@ -1397,19 +1439,17 @@ TEST(GameModelTest, UpdateOnDrawThenCloseGame) {
 
     auto obs = std::make_shared<SessionObserver>(model);
 
-    actualField->attach(obs, 
-        static_cast<int>(evt_t::CREATURE_REMOVE_IN_FIELD));
-    model->attach(obs, 
-        static_cast<int>(evt_t::DRAW_DETERMINATE));
+    actualField->events().subscribe(obs);
+    model->events().subscribe(obs);
 
     model->game();
 
     ASSERT_FALSE(obs->unexpected_);
     ASSERT_TRUE(obs->update_);    
-    std::vector<evt_t> expectEvents {
-        evt_t::CREATURE_REMOVE_IN_FIELD,
-        evt_t::CREATURE_REMOVE_IN_FIELD,
-        evt_t::DRAW_DETERMINATE
+    // поколение приходит одним набором изменений
+    std::vector<seen_t> expectEvents {
+        seen_t::CHANGES_APPLIED,
+        seen_t::DRAW_DETERMINED
     };
     ASSERT_EQ(obs->evt_, expectEvents);
 
@@ -1438,32 +1478,33 @@ TEST(GameModelTest, UpdateOnWinFirstPlayerThenCloseGame) {
     using namespace game_model;
     using namespace creature_strategy;
 
-    using evt_t = game_event::event_t;
+    enum class seen_t { CHANGES_APPLIED, DRAW_DETERMINED, WINNER_DETERMINED };
 
-    struct SessionObserver : observer::IObserver {   
+    struct SessionObserver {   
         SessionObserver(std::shared_ptr<GameModel> model):
             model_(model)
         {}
 
-        void update(int event_t) override {
-            evt_.push_back(static_cast<evt_t>(event_t));
-            
-            switch (evt_.back()) {
-                case evt_t::WINNER_DETERMINATE:
-                    update_ = true;
-                    break;
-                case evt_t::CREATURE_REMOVE_IN_FIELD:
-                    ++creatRemoveCount_;
-                    break;
-                default: 
-                    unexpected_ = true;
-            }
+        void on(const game_event::ChangesApplied&) {
+            evt_.push_back(seen_t::CHANGES_APPLIED);
+            ++creatRemoveCount_;
+            model_->on(game_event::UserAskedClose{});
+        }
 
-            model_->update(static_cast<int>(evt_t::USER_ASKED_CLOSE));
+        void on(const game_event::WinnerDetermined&) {
+            evt_.push_back(seen_t::WINNER_DETERMINED);
+            update_ = true;
+            model_->on(game_event::UserAskedClose{});
+        }
+
+        void on(const game_event::DrawDetermined&) {
+            evt_.push_back(seen_t::DRAW_DETERMINED);
+            unexpected_ = true;
+            model_->on(game_event::UserAskedClose{});
         }
 
         std::shared_ptr<GameModel> model_;
-        std::vector<evt_t> evt_;
+        std::vector<seen_t> evt_;
         bool update_ = false;
         bool unexpected_ = false;
         int creatRemoveCount_ = 0;
@@ -1510,20 +1551,16 @@ TEST(GameModelTest, UpdateOnWinFirstPlayerThenCloseGame) {
 
     auto obs = std::make_shared<SessionObserver>(model);
 
-    actualField->attach(obs, 
-        static_cast<int>(evt_t::CREATURE_REMOVE_IN_FIELD));
-    model->attach(obs, 
-        static_cast<int>(evt_t::DRAW_DETERMINATE));
-    model->attach(obs, 
-        static_cast<int>(evt_t::WINNER_DETERMINATE));
+    actualField->events().subscribe(obs);
+    model->events().subscribe(obs);
 
     model->game();
 
     ASSERT_FALSE(obs->unexpected_);
     ASSERT_TRUE(obs->update_);    
-    std::vector<evt_t> expectEvents {
-        evt_t::CREATURE_REMOVE_IN_FIELD,
-        evt_t::WINNER_DETERMINATE
+    std::vector<seen_t> expectEvents {
+        seen_t::CHANGES_APPLIED,
+        seen_t::WINNER_DETERMINED
     };
     ASSERT_EQ(obs->evt_, expectEvents);
     ASSERT_EQ(model->winnerPlayer(), player[0]);
@@ -1558,32 +1595,33 @@ TEST(GameModelTest, UpdateOnWinSecondPlayerThenCloseGame) {
     using namespace game_model;
     using namespace creature_strategy;
 
-    using evt_t = game_event::event_t;
+    enum class seen_t { CHANGES_APPLIED, DRAW_DETERMINED, WINNER_DETERMINED };
 
-    struct SessionObserver : observer::IObserver {   
+    struct SessionObserver {   
         SessionObserver(std::shared_ptr<GameModel> model):
             model_(model)
         {}
 
-        void update(int event_t) override {
-            evt_.push_back(static_cast<evt_t>(event_t));
-            
-            switch (evt_.back()) {
-                case evt_t::WINNER_DETERMINATE:
-                    update_ = true;
-                    break;
-                case evt_t::CREATURE_REMOVE_IN_FIELD:
-                    ++creatRemoveCount_;
-                    break;
-                default: 
-                    unexpected_ = true;
-            }
+        void on(const game_event::ChangesApplied&) {
+            evt_.push_back(seen_t::CHANGES_APPLIED);
+            ++creatRemoveCount_;
+            model_->on(game_event::UserAskedClose{});
+        }
 
-            model_->update(static_cast<int>(evt_t::USER_ASKED_CLOSE));
+        void on(const game_event::WinnerDetermined&) {
+            evt_.push_back(seen_t::WINNER_DETERMINED);
+            update_ = true;
+            model_->on(game_event::UserAskedClose{});
+        }
+
+        void on(const game_event::DrawDetermined&) {
+            evt_.push_back(seen_t::DRAW_DETERMINED);
+            unexpected_ = true;
+            model_->on(game_event::UserAskedClose{});
         }
 
         std::shared_ptr<GameModel> model_;
-        std::vector<evt_t> evt_;
+        std::vector<seen_t> evt_;
         bool update_ = false;
         bool unexpected_ = false;
         int creatRemoveCount_ = 0;
@@ -1632,20 +1670,16 @@ TEST(GameModelTest, UpdateOnWinSecondPlayerThenCloseGame) {
 
     auto obs = std::make_shared<SessionObserver>(model);
 
-    actualField->attach(obs, 
-        static_cast<int>(evt_t::CREATURE_REMOVE_IN_FIELD));
-    model->attach(obs, 
-        static_cast<int>(evt_t::DRAW_DETERMINATE));
-    model->attach(obs, 
-        static_cast<int>(evt_t::WINNER_DETERMINATE));
+    actualField->events().subscribe(obs);
+    model->events().subscribe(obs);
 
     model->game();
 
     ASSERT_FALSE(obs->unexpected_);
     ASSERT_TRUE(obs->update_);    
-    std::vector<evt_t> expectEvents {
-        evt_t::CREATURE_REMOVE_IN_FIELD,
-        evt_t::WINNER_DETERMINATE
+    std::vector<seen_t> expectEvents {
+        seen_t::CHANGES_APPLIED,
+        seen_t::WINNER_DETERMINED
     };
     ASSERT_EQ(obs->evt_, expectEvents);
     ASSERT_EQ(model->winnerPlayer(), player[1]);
@@ -1673,6 +1707,2691 @@ TEST(GameModelTest, UpdateOnWinSecondPlayerThenCloseGame) {
     ASSERT_TRUE(eqFields(actualField, expectField));
 }
 
+// #################################################################################################
+// flat cell storage tests
+// #################################################################################################
+TEST(FlatCellStorageTest, SetRemoveAndInvalidAccess) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    auto player1 = std::make_shared<player::Player>(1, "player1");
+    auto player2 = std::make_shared<player::Player>(2, "player2");
+
+    auto figure = std::make_unique<figure::DummyFigure>();
+    auto creatureFactory = std::make_unique<CreatureFactory>();
+    auto cellStorage = std::make_unique<FlatCellStorage>();
+    auto field = std::make_shared<GameFieldWithFigure>(
+        3, 2,
+        std::move(creatureFactory),
+        std::move(cellStorage),
+        std::move(figure)
+    );
+
+    ASSERT_EQ(field->width(), 3);
+    ASSERT_EQ(field->height(), 2);
+
+    field->setCreatureInCell(2, 1, player1);
+    field->setCreatureInCell(0, 0, player2);
+    ASSERT_TRUE(field->hasCreatureInCell(2, 1));
+    ASSERT_EQ(field->getCreatureByCell(2, 1).player(), player1);
+    ASSERT_EQ(field->getCreatureByCell(0, 0).player(), player2);
+
+    // Перезаписываем существо
+    field->setCreatureInCell(2, 1, player2);
+    ASSERT_EQ(field->getCreatureByCell(2, 1).player(), player2);
+
+    field->removeCreatureInCell(2, 1);
+    ASSERT_FALSE(field->hasCreatureInCell(2, 1));
+
+    EXPECT_THROW(field->hasCreatureInCell(3, 0), std::out_of_range);
+    EXPECT_THROW(field->hasCreatureInCell(0, 2), std::out_of_range);
+    EXPECT_THROW(field->setCreatureInCell(-1, 0, player1), std::out_of_range);
+}
+
+TEST(FlatCellStorageTest, GliderMatchesCellObjectStorage) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace game_model;
+    using namespace creature_strategy;
+    using namespace cell_storage;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+
+    auto flatField = std::make_shared<GameFieldWithFigure>(
+        6, 6,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>()
+    );
+    auto objectField = std::make_shared<GameFieldWithFigure>(
+        6, 6,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<CellFactory>(),
+        std::make_unique<figure::DummyFigure>()
+    );
+
+    for (auto&& field : { flatField, objectField }) {
+        field->setCreatureInCell(0, 2, player[0]);
+        field->setCreatureInCell(1, 3, player[0]);
+        field->setCreatureInCell(2, 1, player[1]);
+        field->setCreatureInCell(2, 2, player[1]);
+        field->setCreatureInCell(2, 3, player[0]);
+    }
+
+    auto makeModel = [&player] (std::shared_ptr<GameFieldWithFigure> field) {
+        std::pair<int, int> lu {0, 0};
+        std::pair<int, int> rl {5, 5};
+        auto area = std::make_unique<GameFieldWithFigureArea>(field, lu, rl);
+        area->unlock();
+        auto f = std::make_unique<GameFieldWithFigureAreaCurryFactory>(field);
+        return std::make_unique<GameModel>(
+            0, 0, 0, std::move(area), std::move(f), player, 
+            std::make_unique<ConwayCreatureStrategy>());
+    };
+
+    auto flatModel = makeModel(flatField);
+    auto objectModel = makeModel(objectField);
+    for (int i = 0; i < 4; ++i) {
+        flatModel->computeEr_();
+        objectModel->computeEr_();
+        ASSERT_TRUE(eqFields(flatField, objectField));
+    }
+}
+
+// #################################################################################################
+// game engine tests
+// #################################################################################################
+namespace {
+    // заполнить поле случайными существами двух игроков
+    void fillFieldRandomly(
+        std::shared_ptr<game_field::GameFieldWithFigure> field,
+        const std::vector<std::shared_ptr<player::Player>>& players,
+        unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> dist(0, 5);
+        for (int y = 0; y < field->height(); ++y) {
+            for (int x = 0; x < field->width(); ++x) {
+                int v = dist(gen);
+                if (v < static_cast<int>(players.size()) && 
+                    !field->isExcludedCell(x, y)) 
+                {
+                    field->setCreatureInCell(x, y, players[v]);
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<game_model::GameModel> makeModelWithEngine(
+        std::shared_ptr<game_field::GameFieldWithFigure> field,
+        const std::vector<std::shared_ptr<player::Player>>& players,
+        std::unique_ptr<game_engine::IGameEngine> engine,
+        std::unique_ptr<creature_strategy::ICreatureStrategy> strategy = 
+            std::make_unique<creature_strategy::ConwayCreatureStrategy>())
+    {
+        std::pair<int, int> lu {0, 0};
+        std::pair<int, int> rl {field->width() - 1, field->height() - 1};
+        auto area = std::make_unique<
+            game_field_area::GameFieldWithFigureArea>(field, lu, rl);
+        area->unlock();
+        auto f = std::make_unique<
+            factory::GameFieldWithFigureAreaCurryFactory>(field);
+        return std::make_unique<game_model::GameModel>(
+            0, 0, 0, std::move(area), std::move(f), players, 
+            std::move(strategy), std::move(engine));
+    }
+}
+
+TEST(GameEngineTest, BitboardMatchesCellwiseModel) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+
+    // ширина больше 64, чтобы задеть перенос между словами
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            70, 9,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    fillFieldRandomly(actualField, player, 7);
+    fillFieldRandomly(expectField, player, 7);
+
+    auto actualModel = makeModelWithEngine(actualField, player, 
+        std::make_unique<BitboardGameEngine>(actualField));
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr);
+    for (int i = 0; i < 10; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField));
+    }
+}
+
+TEST(GameEngineTest, BitboardMatchesCellwiseModelWithExtraNeighbors) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+
+    auto makeField = [] {
+        return std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+            21, 21,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    ASSERT_FALSE(actualField->cellsWithExtraNeighbors().empty());
+    fillFieldRandomly(actualField, player, 11);
+    fillFieldRandomly(expectField, player, 11);
+
+    auto actualModel = makeModelWithEngine(actualField, player, 
+        std::make_unique<BitboardGameEngine>(actualField));
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr);
+    for (int i = 0; i < 10; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField));
+    }
+}
+
+TEST(GameEngineTest, BitboardMatchesCellwiseModelWithFigure) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            21, 21,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::Romb>(10, 10));
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    fillFieldRandomly(actualField, player, 13);
+    fillFieldRandomly(expectField, player, 13);
+
+    auto actualModel = makeModelWithEngine(actualField, player, 
+        std::make_unique<BitboardGameEngine>(actualField));
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr);
+    for (int i = 0; i < 10; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFieldsInFigure(actualField, expectField));
+    }
+}
+
+TEST(GameEngineTest, BitboardRequiresFlatStorage) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        4, 4,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<CellFactory>(),
+        std::make_unique<figure::DummyFigure>());
+    auto model = makeModelWithEngine(field, player, 
+        std::make_unique<BitboardGameEngine>(field));
+    EXPECT_THROW(model->computeEr_(), std::logic_error);
+}
+
+TEST(GameEngineTest, BitboardSeesFieldChangesBetweenGenerations) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player {
+        std::make_shared<player::Player>(1, "player1"),
+        std::make_shared<player::Player>(2, "player2"),
+    };
+
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            70, 9,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    fillFieldRandomly(actualField, player, 17);
+    fillFieldRandomly(expectField, player, 17);
+
+    auto actualModel = makeModelWithEngine(actualField, player,
+        std::make_unique<BitboardGameEngine>(actualField));
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr);
+    // плоскости движка переживают поколение, а поле меняется между ними
+    for (int i = 0; i < 6; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField));
+        for (auto&& field : { actualField, expectField }) {
+            field->setCreatureInCell(i * 11, i, player[i % 2]);
+            field->setCreatureInCell(i * 11 + 1, i, player[i % 2]);
+            field->setCreatureInCell(i * 11 + 2, i, player[i % 2]);
+            if (field->hasCreatureInCell(69 - i, 8 - i)) {
+                field->removeCreatureInCell(69 - i, 8 - i);
+            }
+        }
+    }
+    actualField->clear();
+    expectField->clear();
+    fillFieldRandomly(actualField, player, 19);
+    fillFieldRandomly(expectField, player, 19);
+    actualModel->computeEr_();
+    expectModel->computeEr_();
+    EXPECT_TRUE(eqFields(actualField, expectField));
+}
+
+TEST(GameEngineTest, ByteGridMatchesCellwiseModel) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+
+    auto makeField = [] {
+        return std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+            45, 40,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    fillFieldRandomly(actualField, player, 17);
+    fillFieldRandomly(expectField, player, 17);
+
+    auto actualModel = makeModelWithEngine(actualField, player, 
+        std::make_unique<ByteGridGameEngine>(actualField));
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr);
+    for (int i = 0; i < 10; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField));
+    }
+}
+
+// #################################################################################################
+// neighbor kernel tests
+// #################################################################################################
+TEST(NeighborKernelTest, VectorKernelsMatchScalar) {
+    using namespace neighbor_kernel;
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> dist(0, 1);
+    for (int width : { 1, 15, 16, 17, 31, 32, 33, 100 }) {
+        int stride = width + 2;
+        std::vector<std::uint8_t> grid(stride * 3);
+        for (auto&& c : grid) {
+            c = dist(gen);
+        }
+        const std::uint8_t* row = grid.data() + stride + 1;
+
+        std::vector<std::uint8_t> expect(width);
+        sumRowNeighbors(kernel_t::SCALAR, 
+            row - stride, row, row + stride, expect.data(), width);
+        for (int x = 0; x < width; ++x) {
+            int sum = 0;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (dx || dy) sum += row[dy * stride + x + dx];
+                }
+            }
+            ASSERT_EQ(expect[x], sum);
+        }
+
+        for (auto kernel : { kernel_t::SSE2, kernel_t::AVX2 }) {
+            if (!isKernelSupported(kernel)) continue;
+            std::vector<std::uint8_t> actual(width);
+            sumRowNeighbors(kernel, 
+                row - stride, row, row + stride, actual.data(), width);
+            ASSERT_EQ(actual, expect);
+        }
+    }
+}
+
+// #################################################################################################
+// neighbor table tests
+// #################################################################################################
+TEST(NeighborTableTest, BoundedFieldNeighbors) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    auto field = std::make_shared<GameFieldWithFigure>(
+        5, 4,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    auto table = field->neighborTable();
+    ASSERT_EQ(table->offsets().size(), 5 * 4 + 1);
+    ASSERT_EQ(table->neighbors(table->index(0, 0)).size(), 3);
+    ASSERT_EQ(table->neighbors(table->index(2, 0)).size(), 5);
+    ASSERT_EQ(table->neighbors(table->index(2, 2)).size(), 8);
+
+    auto ne = table->neighbors(table->index(0, 0));
+    std::vector<std::uint32_t> actual(ne.begin(), ne.end());
+    std::vector<std::uint32_t> expect { 
+        table->index(1, 0), table->index(0, 1), table->index(1, 1) 
+    };
+    ASSERT_EQ(actual, expect);
+    ASSERT_TRUE(field->cellsWithExtraNeighbors().empty());
+}
+
+TEST(NeighborTableTest, LinksAppendNeighborsOfLinkedCell) {
+    using namespace neighbor_table;
+
+    // поле 3x1: у крайних клеток по одному соседу, у средней два
+    NeighborTable table(3, 1, { 0, 1, 3, 4 }, { 1, 0, 2, 1 });
+    auto linked = table.withLinks({ { {0, 0}, {2, 0} } });
+
+    auto ne = linked.neighbors(0);
+    ASSERT_EQ(std::vector<std::uint32_t>(ne.begin(), ne.end()),
+              std::vector<std::uint32_t>({ 1, 1 }));
+    ASSERT_EQ(linked.neighbors(1).size(), 2);
+    ASSERT_EQ(linked.linkedCells(), std::vector<std::uint32_t>{ 0 });
+    ASSERT_THROW(NeighborTable(3, 1, { 0, 1 }, { 1 }), std::logic_error);
+}
+
+TEST(NeighborTableTest, ClearKeepsNeighborTable) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    std::shared_ptr<player::Player> player = 
+        std::make_shared<player::Player>(1, "player1");
+    auto field = std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+        21, 21,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<CellFactory>(),
+        std::make_unique<figure::DummyFigure>());
+    auto table = field->neighborTable();
+    auto cells = field->cellsWithExtraNeighbors();
+    ASSERT_FALSE(cells.empty());
+
+    field->setCreatureInCell(1, 1, player);
+    field->clear();
+    ASSERT_EQ(field->neighborTable(), table);
+    ASSERT_EQ(field->cellsWithExtraNeighbors(), cells);
+    ASSERT_FALSE(field->hasCreatureInCell(1, 1));
+    field->setCreatureInCell(1, 1, player);
+    ASSERT_EQ(field->countCellNeighborsCreatures(0, 0).at(player), 1);
+}
+
+TEST(NeighborTableTest, CountsArrayMatchesCountsMap) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    std::vector<std::shared_ptr<GameFieldWithFigure>> fields {
+        std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+            21, 21,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<CellFactory>(),
+            std::make_unique<figure::DummyFigure>()),
+        std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+            21, 21,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>())
+    };
+    for (auto&& field : fields) {
+        fillFieldRandomly(field, player, 5);
+        neighbor_counts_t count;
+        for (int y = 0; y < field->height(); ++y) {
+            for (int x = 0; x < field->width(); ++x) {
+                auto expect = field->countCellNeighborsCreatures(x, y);
+                field->countCellNeighborsCreatures(x, y, count);
+                for (int id = 0; id < maxPlayers; ++id) {
+                    int c = 0;
+                    for (auto&& [p, n] : expect) {
+                        if (p->id() == id) c = n;
+                    }
+                    ASSERT_EQ(count[id], c);
+                }
+            }
+        }
+    }
+}
+
+// #################################################################################################
+// player registry tests
+// #################################################################################################
+TEST(PlayerRegistryTest, RegisterAndResolvePlayers) {
+    using namespace factory;
+    using namespace cell_storage;
+
+    auto player1 = std::make_shared<player::Player>(0, "player1");
+    auto player2 = std::make_shared<player::Player>(3, "player2");
+    CreatureFactory creatFactory;
+    player::PlayerRegistry registry;
+
+    ASSERT_FALSE(registry.contains(1));
+    ASSERT_EQ(registry.registerPlayer(player1, creatFactory), 1);
+    ASSERT_EQ(registry.registerPlayer(player2, creatFactory), 4);
+    ASSERT_EQ(registry.registerPlayer(player1, creatFactory), 1);
+    ASSERT_EQ(registry.player(1), player1);
+    ASSERT_EQ(registry.creature(4).player(), player2);
+    ASSERT_EQ(registry.player(emptyOwner), nullptr);
+    ASSERT_THROW(registry.creature(2), std::logic_error);
+
+    auto sameId = std::make_shared<player::Player>(3, "player3");
+    ASSERT_THROW(registry.registerPlayer(sameId, creatFactory), std::logic_error);
+    auto bigId = std::make_shared<player::Player>(maxPlayers, "player4");
+    ASSERT_THROW(registry.registerPlayer(bigId, creatFactory), std::out_of_range);
+}
+
+TEST(PlayerRegistryTest, CellsStoreOwnerOnly) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    auto player1 = std::make_shared<player::Player>(1, "player1");
+    auto field = std::make_shared<GameFieldWithFigure>(
+        3, 3,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<CellFactory>(),
+        std::make_unique<figure::DummyFigure>());
+
+    field->setCreatureInCell(1, 1, player1);
+    field->setCreatureInCell(2, 1, player1);
+    ASSERT_EQ(field->storage().owner(1, 1), 2);
+    // у всех клеток игрока одно существо
+    ASSERT_EQ(&field->getCreatureByCell(1, 1), &field->getCreatureByCell(2, 1));
+
+    field->removeCreatureInCell(1, 1);
+    ASSERT_EQ(field->storage().owner(1, 1), emptyOwner);
+    ASSERT_THROW(field->getCreatureByCell(1, 1), std::logic_error);
+    ASSERT_EQ(field->countCellNeighborsCreatures(1, 1).at(player1), 1);
+}
+
+// #################################################################################################
+// generation buffer tests
+// #################################################################################################
+TEST(GenerationBufferTest, SwapKeepsPreviousGeneration) {
+    using namespace factory;
+    using namespace cell_storage;
+
+    std::vector<std::unique_ptr<ICellStorage>> storages;
+    storages.emplace_back(
+        std::make_unique<CellObjectStorage>(std::make_unique<CellFactory>()));
+    storages.emplace_back(std::make_unique<FlatCellStorage>());
+    for (auto&& storage : storages) {
+        storage->reset(3, 2);
+        storage->setOwner(0, 0, 1);
+        storage->setOwner(2, 1, 2);
+
+        storage->beginGeneration();
+        storage->setNextOwner(0, 0, emptyOwner);
+        storage->setNextOwner(1, 1, 2);
+        // до обмена текущее поколение не меняется
+        ASSERT_EQ(storage->owner(0, 0), 1);
+        ASSERT_EQ(storage->owner(1, 1), emptyOwner);
+
+        storage->swapGeneration();
+        ASSERT_EQ(storage->owner(0, 0), emptyOwner);
+        ASSERT_EQ(storage->owner(1, 1), 2);
+        ASSERT_EQ(storage->owner(2, 1), 2);
+        ASSERT_EQ(storage->previousOwner(0, 0), 1);
+        ASSERT_EQ(storage->previousOwner(1, 1), emptyOwner);
+        ASSERT_THROW(storage->previousOwner(3, 0), std::out_of_range);
+    }
+}
+
+TEST(GenerationBufferTest, DiffListsChangedCellsOfRowRange) {
+    using namespace factory;
+    using namespace cell_storage;
+
+    std::vector<std::unique_ptr<ICellStorage>> storages;
+    storages.emplace_back(
+        std::make_unique<CellObjectStorage>(std::make_unique<CellFactory>()));
+    storages.emplace_back(std::make_unique<FlatCellStorage>());
+    storages.emplace_back(std::make_unique<CountingCellStorage>());
+    for (auto&& storage : storages) {
+        // строка длиннее 8 клеток: равные отрезки пропускаются целиком
+        storage->reset(20, 2);
+        storage->setNeighborTable(std::make_shared<
+            const neighbor_table::NeighborTable>(
+                20, 2, std::vector<std::uint32_t>(41, 0),
+                std::vector<std::uint32_t>{}));
+        storage->setOwner(3, 1, 1);
+        storage->setOwner(17, 1, 2);
+
+        storage->beginGeneration();
+        storage->setNextOwner(3, 1, emptyOwner);
+        storage->setNextOwner(12, 1, 1);
+        storage->setNextOwner(17, 1, 1);
+        storage->setNextOwner(5, 0, 2);
+        storage->swapGeneration();
+
+        std::vector<row_change_t> diff;
+        storage->diffGeneration(1, 0, 20, diff);
+        std::vector<row_change_t> expect {
+            {3, 1, emptyOwner}, {12, emptyOwner, 1}, {17, 2, 1}
+        };
+        ASSERT_EQ(diff, expect);
+
+        // отрезок ограничивает сравнение, diff дописывается
+        storage->diffGeneration(1, 4, 13, diff);
+        ASSERT_EQ(diff.size(), 4);
+        ASSERT_EQ(diff.back(), (row_change_t{12, emptyOwner, 1}));
+    }
+}
+
+TEST(GenerationBufferTest, SpanReadMatchesCheckedAccessors) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    std::vector<std::unique_ptr<ICellStorage>> storages;
+    storages.emplace_back(
+        std::make_unique<CellObjectStorage>(std::make_unique<CellFactory>()));
+    storages.emplace_back(std::make_unique<FlatCellStorage>());
+    storages.emplace_back(std::make_unique<CountingCellStorage>());
+    for (auto&& storage : storages) {
+        auto field = std::make_shared<GameFieldWithFigure>(
+            21, 21,
+            std::make_unique<CreatureFactory>(),
+            std::move(storage),
+            std::make_unique<figure::Romb>(10, 10),
+            topology::topology_t::TORUS);
+        fillFieldRandomly(field, player, 17);
+        GameFieldWithFigureArea area(
+            field, std::make_pair(2, 3), std::make_pair(18, 17));
+        area.unlock();
+
+        int cells = 0;
+        for (int y = 0; y < field->height(); ++y) {
+            area.forEachAvailableSpan(y, [&] (int begin, int end) {
+                std::vector<owner_t> owners(end - begin);
+                std::vector<neighbor_counts_t> counts(end - begin);
+                area.readSpan(y, begin, owners, counts);
+                for (int x = begin; x < end; ++x) {
+                    neighbor_counts_t expect;
+                    area.countCellNeighborsCreatures(x, y, expect);
+                    ASSERT_EQ(counts[x - begin], expect);
+                    ASSERT_EQ(owners[x - begin] != emptyOwner,
+                              area.hasCreatureInCell(x, y));
+                    ++cells;
+                }
+            });
+        }
+        ASSERT_GT(cells, 0);
+
+        // проверенные точки входа отклоняют клетки вне фигуры,
+        // вне прямоугольника и закрытой зоны
+        ASSERT_TRUE(field->isExcludedCell(2, 3));
+        ASSERT_THROW(area.hasCreatureInCell(2, 3), std::logic_error);
+        ASSERT_THROW(area.hasCreatureInCell(10, 1), std::logic_error);
+        area.lock();
+        ASSERT_THROW(area.hasCreatureInCell(10, 10), std::logic_error);
+    }
+}
+
+TEST(GenerationBufferTest, SwapNotifiesChangedCellsOnly) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    enum class evt_t { CREATURE_SET, CREATURE_REMOVED, CHANGES_APPLIED };
+
+    struct CellObserver {
+        void on(const game_event::CreatureSet& evt)
+        { record_(evt_t::CREATURE_SET, *evt.changes); }
+
+        void on(const game_event::CreatureRemoved& evt)
+        { record_(evt_t::CREATURE_REMOVED, *evt.changes); }
+
+        void on(const game_event::ChangesApplied& evt)
+        { record_(evt_t::CHANGES_APPLIED, *evt.changes); }
+
+        void record_(evt_t evt, const change_set::ChangeSet& changes) {
+            changes.forEach([&] (int x, int y, owner_t own) {
+                cells_.emplace_back(evt, change_t{ x, y, own });
+            });
+        }
+
+        std::vector<std::pair<evt_t, change_t>> cells_;
+    };
+
+    auto player1 = std::make_shared<player::Player>(1, "player1");
+    auto field = std::make_shared<GameFieldWithFigure>(
+        4, 4,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    field->setCreatureInCell(1, 1, player1);
+    field->setCreatureInCell(2, 2, player1);
+
+    auto obs = std::make_shared<CellObserver>();
+    field->events().subscribe(obs);
+
+    field->beginGeneration();
+    field->setNextOwner(2, 2, emptyOwner);
+    field->setNextOwner(3, 0, 2);
+    // тот же владелец - клетка не изменилась
+    field->setNextOwner(1, 1, 2);
+    ASSERT_TRUE(obs->cells_.empty());
+    field->swapGeneration();
+
+    // поколение приходит одним набором в построчном порядке
+    std::vector<std::pair<evt_t, change_t>> expect {
+        { evt_t::CHANGES_APPLIED, {3, 0, 2} },
+        { evt_t::CHANGES_APPLIED, {2, 2, emptyOwner} },
+    };
+    ASSERT_EQ(obs->cells_, expect);
+
+    obs->cells_.clear();
+    field->setCreatureInCell(0, 3, player1);
+    field->removeCreatureInCell(1, 1);
+    expect = {
+        { evt_t::CREATURE_SET, {0, 3, 2} },
+        { evt_t::CREATURE_REMOVED, {1, 1, emptyOwner} },
+    };
+    ASSERT_EQ(obs->cells_, expect);
+}
+
+// #################################################################################################
+// active tiles tests
+// #################################################################################################
+TEST(ActiveTilesTest, ChangedTileActivatesNeighbors) {
+    using namespace active_tiles;
+    constexpr int t = ActiveTiles::tileSize;
+
+    ActiveTiles bounded(4 * t, 3 * t, topology::topology_t::BOUNDED);
+    bounded.activate();
+    ASSERT_EQ(bounded.activeCount(), 12);
+    bounded.activate();
+    ASSERT_EQ(bounded.activeCount(), 0);
+
+    bounded.markChanged(0, 0);
+    bounded.activate();
+    ASSERT_EQ(bounded.activeCount(), 4);
+    ASSERT_TRUE(bounded.isActive(1, 1));
+    ASSERT_FALSE(bounded.isActive(3, 0));
+
+    ActiveTiles torus(4 * t, 3 * t, topology::topology_t::TORUS);
+    torus.activate();
+    torus.markChanged(0, 0);
+    torus.pin(2 * t + 1, t);
+    torus.activate();
+    ASSERT_EQ(torus.activeCount(), 10);
+    ASSERT_TRUE(torus.isActive(3, 2));
+    ASSERT_TRUE(torus.isActive(2, 1));
+}
+
+TEST(ActiveTilesTest, StillLifeDeactivatesTiles) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        64, 64,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    // блок внутри плитки (1, 1)
+    field->setCreatureInCell(20, 20, player[0]);
+    field->setCreatureInCell(21, 20, player[0]);
+    field->setCreatureInCell(20, 21, player[0]);
+    field->setCreatureInCell(21, 21, player[0]);
+    auto model = makeModelWithEngine(field, player, nullptr);
+
+    model->computeEr_();
+    ASSERT_EQ(field->activeTiles().activeCount(), 16);
+    model->computeEr_();
+    ASSERT_EQ(field->activeTiles().activeCount(), 0);
+    ASSERT_TRUE(field->hasCreatureInCell(21, 21));
+
+    field->setCreatureInCell(40, 40, player[1]);
+    model->computeEr_();
+    ASSERT_EQ(field->activeTiles().activeCount(), 9);
+    ASSERT_FALSE(field->hasCreatureInCell(40, 40));
+    ASSERT_TRUE(field->hasCreatureInCell(20, 20));
+}
+
+// #################################################################################################
+// hashlife tests
+// #################################################################################################
+TEST(HashLifeTest, GliderJumpsManyGenerations) {
+    using namespace hashlife;
+
+    rule_t birth{}, survive{};
+    birth[3] = true;
+    survive[2] = survive[3] = true;
+    Universe universe(birth, survive);
+    // глайдер, летящий на юго-восток
+    universe.setCell(1, 0, 1);
+    universe.setCell(2, 1, 1);
+    universe.setCell(0, 2, 2);
+    universe.setCell(1, 2, 2);
+    universe.setCell(2, 2, 1);
+    ASSERT_TRUE(universe.isDeterministic());
+
+    universe.step(10);
+    ASSERT_EQ(universe.generation(), 1024);
+    ASSERT_EQ(universe.population(), 5);
+    // за 4 поколения глайдер сдвигается на клетку по диагонали
+    ASSERT_EQ(universe.population(1, 256, 256, 259, 259) + 
+              universe.population(2, 256, 256, 259, 259), 5);
+    ASSERT_TRUE(universe.owners(0, 0, 256, 256).empty());
+    ASSERT_FALSE(universe.owners(256, 256, 259, 259).empty());
+
+    birth[4] = true;
+    Universe tie(birth, survive);
+    tie.setCell(0, 0, 1);
+    tie.setCell(5, 5, 2);
+    ASSERT_FALSE(tie.isDeterministic());
+    ASSERT_THROW(tie.step(0), std::logic_error);
+    ASSERT_THROW(tie.setCell(9, 9, 3), std::logic_error);
+}
+
+TEST(HashLifeTest, MatchesCellwiseModel) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            37, 29,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    fillFieldRandomly(actualField, player, 17);
+    fillFieldRandomly(expectField, player, 17);
+
+    auto engine = std::make_unique<HashLifeGameEngine>(actualField, nullptr);
+    auto hashLife = engine.get();
+    auto actualModel = makeModelWithEngine(actualField, player, 
+        std::move(engine));
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr);
+    for (int i = 0; i < 20; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField));
+    }
+    ASSERT_NE(hashLife->universe(), nullptr);
+}
+
+TEST(HashLifeTest, ChangesSinceCheckpointMatchStoredCells) {
+    using namespace hashlife;
+    using namespace cell_storage;
+
+    rule_t birth{}, survive{};
+    birth[3] = true;
+    survive[2] = survive[3] = true;
+    Universe universe(birth, survive);
+    // мигалка и блок
+    for (int x = 3; x < 6; ++x) {
+        universe.setCell(x, 4, 1);
+    }
+    for (auto [x, y] : { std::pair{10, 10}, {11, 10}, {10, 11}, {11, 11} }) {
+        universe.setCell(x, y, 2);
+    }
+    std::vector<owner_t> before;
+    universe.store(16, 16, before);
+    universe.checkpoint();
+    universe.step(0);
+    std::vector<owner_t> after;
+    universe.store(16, 16, after);
+
+    std::vector<change_t> changes;
+    universe.changesSinceCheckpoint(16, 16, changes);
+    std::vector<change_t> expect;
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            auto idx = static_cast<std::size_t>(y) * 16 + x;
+            if (before[idx] != after[idx]) {
+                expect.emplace_back(x, y, after[idx]);
+            }
+        }
+    }
+    std::sort(changes.begin(), changes.end());
+    std::sort(expect.begin(), expect.end());
+    // блок не меняется, мигалка поворачивается
+    ASSERT_EQ(changes.size(), 4);
+    ASSERT_EQ(changes, expect);
+}
+
+TEST(HashLifeTest, KeepsTreeBetweenStepsAndSeesFieldChanges) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player {
+        std::make_shared<player::Player>(1, "player1"),
+        std::make_shared<player::Player>(2, "player2"),
+    };
+
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            37, 29,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    fillFieldRandomly(actualField, player, 23);
+    fillFieldRandomly(expectField, player, 23);
+
+    auto engine = std::make_unique<HashLifeGameEngine>(actualField, nullptr);
+    auto hashLife = engine.get();
+    auto actualModel = makeModelWithEngine(actualField, player,
+        std::move(engine));
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr);
+    for (int i = 0; i < 6; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField));
+        // дерево не пересоздаётся: поколения копятся
+        ASSERT_EQ(hashLife->universe()->generation(), i + 1);
+    }
+    // поле изменено не через движок: дерево загружается заново
+    for (auto&& field : { actualField, expectField }) {
+        field->setCreatureInCell(17, 14, player[0]);
+        field->setCreatureInCell(18, 14, player[0]);
+        field->setCreatureInCell(19, 14, player[0]);
+    }
+    for (int i = 0; i < 6; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField));
+    }
+}
+
+TEST(HashLifeTest, JumpAwayFromBorderAndFallback) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+    using namespace creature_strategy;
+
+    struct CountingEngine : IGameEngine {
+        void computeEr(IGameFieldArea&, const TransitionTable&, 
+                       const counter_rng::CounterRng&) override 
+        { ++calls_; }
+        int calls_ = 0;
+    };
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+        std::make_shared<player::Player>(3, "player3"),  
+    };
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            64, 64,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    for (auto&& field : { actualField, expectField }) {
+        field->setCreatureInCell(21, 20, player[0]);
+        field->setCreatureInCell(22, 21, player[0]);
+        field->setCreatureInCell(20, 22, player[1]);
+        field->setCreatureInCell(21, 22, player[1]);
+        field->setCreatureInCell(22, 22, player[0]);
+    }
+
+    auto fallback = std::make_unique<CountingEngine>();
+    auto counting = fallback.get();
+    HashLifeGameEngine engine(actualField, std::move(fallback), 3);
+    GameFieldWithFigureArea area(actualField, {0, 0}, {63, 63});
+    area.unlock();
+    engine.computeEr(area, conwayTable, counter_rng::CounterRng());
+    ASSERT_EQ(counting->calls_, 0);
+
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr);
+    for (int i = 0; i < 8; ++i) {
+        expectModel->computeEr_();
+    }
+    ASSERT_TRUE(eqFields(actualField, expectField));
+    ASSERT_EQ(engine.ownersInArea(area).size(), 2);
+
+    // третий игрок не поддерживается цветным HashLife
+    actualField->setCreatureInCell(5, 5, player[2]);
+    engine.computeEr(area, conwayTable, counter_rng::CounterRng());
+    ASSERT_EQ(counting->calls_, 1);
+    ASSERT_EQ(engine.universe(), nullptr);
+}
+
+// #################################################################################################
+// transition table tests
+// #################################################################################################
+TEST(TransitionTableTest, ConwayIsSampledTable) {
+    using namespace creature_strategy;
+
+    struct LambdaStrategy : ICreatureStrategy {
+        bool computeLiveStatus(int n, bool isAlive) override 
+        { return (n == 2 && isAlive) || n == 3; }
+    };
+    LambdaStrategy lambda;
+    ConwayCreatureStrategy conway;
+    ASSERT_EQ(lambda.transitionTable(), conwayTable);
+    ASSERT_EQ(conway.transitionTable(), conwayTable);
+    for (int n = 0; n <= TransitionTable::maxNeighbors; ++n) {
+        for (bool isAlive : { false, true }) {
+            ASSERT_EQ(conway.computeLiveStatus(n, isAlive), 
+                      lambda.computeLiveStatus(n, isAlive));
+            ASSERT_EQ(conwayTable.next(isAlive, n), 
+                      lambda.computeLiveStatus(n, isAlive));
+        }
+    }
+    ASSERT_FALSE(conway.computeLiveStatus(-1, true));
+    ASSERT_FALSE(conway.computeLiveStatus(17, true));
+    static_assert(conwayTable.birth(3) && !conwayTable.birth(2));
+    static_assert(conwayTable.survive(2) && !conwayTable.survive(4));
+}
+
+TEST(TransitionTableTest, UserStrategyIsSampledOnce) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace creature_strategy;
+
+    // B36/S23, считает обращения к стратегии
+    struct CountingStrategy : ICreatureStrategy {
+        CountingStrategy(int& calls) : calls_(calls) {}
+        bool computeLiveStatus(int n, bool isAlive) override { 
+            ++calls_;
+            return (n == 2 && isAlive) || n == 3 || (n == 6 && !isAlive); 
+        }
+        int& calls_;
+    };
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        8, 8,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    // при шести соседях пустая клетка рождает существо только по B36
+    for (auto [x, y] : { std::pair{ 1, 1 }, { 2, 1 }, { 3, 1 }, 
+                         { 1, 3 }, { 2, 3 }, { 3, 3 } }) 
+    {
+        field->setCreatureInCell(x, y, player[x == 1 ? 1 : 0]);
+    }
+
+    int calls = 0;
+    auto area = std::make_unique<GameFieldWithFigureArea>(
+        field, std::pair{ 0, 0 }, std::pair{ 7, 7 });
+    area->unlock();
+    auto f = std::make_unique<GameFieldWithFigureAreaCurryFactory>(field);
+    game_model::GameModel model(
+        0, 0, 0, std::move(area), std::move(f), player, 
+        std::make_unique<CountingStrategy>(calls));
+    ASSERT_EQ(calls, 2 * (TransitionTable::maxNeighbors + 1));
+
+    model.computeEr_();
+    ASSERT_EQ(calls, 2 * (TransitionTable::maxNeighbors + 1));
+    ASSERT_EQ(field->getCreatureByCell(2, 2).player(), player[0]);
+}
+
+TEST(TransitionTableTest, RuleStringsParseAtCompileTime) {
+    using namespace creature_strategy;
+
+    static_assert(parseRule("B3/S23") == conwayTable);
+    static_assert(parseRule("s23/b3") == conwayTable);
+    static_assert(HighLifeCreatureStrategy::table.birth(6));
+    static_assert(!HighLifeCreatureStrategy::table.survive(6));
+    static_assert(DayAndNightCreatureStrategy::table 
+                  == TransitionTable(0b111001000, 0b111011000));
+    static_assert(parseRule("B/S") == TransitionTable());
+
+    ParsedRuleCreatureStrategy highLife("B36/S23");
+    ASSERT_EQ(highLife.transitionTable(), HighLifeCreatureStrategy::table);
+    for (auto rule : { "", "B3", "B3/", "B3/S23/", "B3/B23", 
+                       "3/23", "B9/S23", "B3/S2x", "B3 /S23" }) 
+    {
+        ASSERT_THROW(ParsedRuleCreatureStrategy{ rule }, 
+                     std::invalid_argument) << rule;
+    }
+}
+
+TEST(TransitionTableTest, HighLifeOnBitboardMatchesCellwiseModel) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+    using namespace creature_strategy;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            70, 30,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto actualField = makeField();
+    auto expectField = makeField();
+    // при B6 возможна ничья 3 на 3: с одним зерном 
+    // движок и модель разрешают её одинаково
+    fillFieldRandomly(actualField, player, 41);
+    fillFieldRandomly(expectField, player, 41);
+
+    auto actualModel = makeModelWithEngine(actualField, player, 
+        std::make_unique<BitboardGameEngine>(actualField),
+        std::make_unique<HighLifeCreatureStrategy>());
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr,
+        std::make_unique<ParsedRuleCreatureStrategy>("B36/S23"));
+    actualModel->setSeed(17);
+    expectModel->setSeed(17);
+    for (int i = 0; i < 10; ++i) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField));
+    }
+}
+
+// #################################################################################################
+// stencil tests
+// #################################################################################################
+TEST(StencilTest, FieldNeighborsFollowStencil) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    static_assert(stencil::Moore::size == 8 && stencil::Moore::radius == 1);
+    static_assert(stencil::VonNeumann::size == 4);
+    using Far = stencil::Stencil<stencil::offset_t{ -2, 0 }, 
+                                 stencil::offset_t{ 0, 3 }>;
+    static_assert(Far::radius == 3);
+
+    GameFieldWithFigure field(
+        5, 5,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>(),
+        stencil::VonNeumann{});
+    ASSERT_EQ(field.neighborTable()->neighbors(
+        field.neighborTable()->index(2, 2)).size(), 4);
+    ASSERT_EQ(field.neighborTable()->neighbors(
+        field.neighborTable()->index(0, 0)).size(), 2);
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+    };
+    field.setCreatureInCell(1, 1, player[0]);
+    field.setCreatureInCell(3, 2, player[0]);
+    field.setCreatureInCell(1, 2, player[0]);
+    neighbor_counts_t ne;
+    field.countCellNeighborsCreatures(2, 2, ne);
+    // диагональная клетка (1, 1) не соседка
+    ASSERT_EQ(ne[1], 2);
+}
+
+TEST(StencilTest, StencilEngineMatchesCellwiseModel) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+    using namespace creature_strategy;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    // соседи Мура и точки, связанные треугольником
+    auto makeTriangular = [] {
+        return std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+            37, 29,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto makeVonNeumann = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            37, 29,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>(),
+            stencil::VonNeumann{});
+    };
+
+    auto mooreField = makeTriangular();
+    auto mooreExpect = makeTriangular();
+    auto vonNeumannField = makeVonNeumann();
+    auto vonNeumannExpect = makeVonNeumann();
+    fillFieldRandomly(mooreField, player, 43);
+    fillFieldRandomly(mooreExpect, player, 43);
+    fillFieldRandomly(vonNeumannField, player, 43);
+    fillFieldRandomly(vonNeumannExpect, player, 43);
+    auto mooreModel = makeModelWithEngine(mooreField, player, 
+        std::make_unique<MooreGameEngine>(mooreField));
+    auto mooreExpectModel = makeModelWithEngine(
+        mooreExpect, player, nullptr);
+    // при одном или трёх соседях из четырёх ничьей не бывает
+    auto vonNeumannModel = makeModelWithEngine(vonNeumannField, player, 
+        std::make_unique<VonNeumannGameEngine>(vonNeumannField),
+        std::make_unique<ParsedRuleCreatureStrategy>("B13/S123"));
+    auto vonNeumannExpectModel = makeModelWithEngine(
+        vonNeumannExpect, player, nullptr,
+        std::make_unique<ParsedRuleCreatureStrategy>("B13/S123"));
+    for (int i = 0; i < 10; ++i) {
+        mooreModel->computeEr_();
+        mooreExpectModel->computeEr_();
+        ASSERT_TRUE(eqFields(mooreField, mooreExpect));
+        vonNeumannModel->computeEr_();
+        vonNeumannExpectModel->computeEr_();
+        ASSERT_TRUE(eqFields(vonNeumannField, vonNeumannExpect));
+    }
+}
+
+TEST(StencilTest, EngineRequiresFieldNeighborhood) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    auto field = std::make_shared<GameFieldWithFigure>(
+        8, 8,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>(),
+        stencil::VonNeumann{});
+    ASSERT_THROW(MooreGameEngine{ field }, std::logic_error);
+    ASSERT_THROW(BitboardGameEngine{ field }, std::logic_error);
+    ASSERT_NO_THROW(VonNeumannGameEngine{ field });
+}
+
+// #################################################################################################
+// figure mask tests
+// #################################################################################################
+TEST(FigureMaskTest, RombRasterMatchesFigure) {
+    figure::Romb romb(10, 7);
+    figure_mask::FigureMask mask(21, 15, romb);
+
+    int count = 0;
+    for (int y = 0; y < 15; ++y) {
+        std::vector<bool> fromSpans(21);
+        int prevEnd = -1;
+        for (auto [begin, end] : mask.rowSpans(y)) {
+            ASSERT_LT(prevEnd, begin);
+            ASSERT_LT(begin, end);
+            for (int x = begin; x < end; ++x) fromSpans[x] = true;
+            prevEnd = end;
+        }
+        for (int x = 0; x < 21; ++x) {
+            bool inside = romb.isPointInFigure(x, y);
+            ASSERT_EQ(mask.contains(x, y), inside);
+            ASSERT_EQ(fromSpans[x], inside);
+            count += inside;
+        }
+    }
+    ASSERT_EQ(mask.cellCount(), count);
+    ASSERT_FALSE(mask.isFull());
+    ASSERT_FALSE(mask.contains(-1, 7));
+    ASSERT_FALSE(mask.contains(10, 15));
+    ASSERT_TRUE(mask.rowSpans(-1).empty());
+    // ромб выпуклый: одна строка - один отрезок
+    ASSERT_EQ(mask.rowSpans(7).size(), 1);
+    ASSERT_EQ(mask.rowSpans(7)[0], (figure_mask::span_t{ 3, 18 }));
+
+    figure::DummyFigure dummy;
+    ASSERT_TRUE(figure_mask::FigureMask(5, 3, dummy).isFull());
+}
+
+TEST(FigureMaskTest, AreaSpansFollowBoundsAndLock) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+
+    auto field = std::make_shared<GameFieldWithFigure>(
+        21, 21,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::Romb>(10, 10));
+    GameFieldWithFigureArea area(field, { 3, 2 }, { 12, 18 });
+    area.unlock();
+
+    for (int y = -1; y <= 21; ++y) {
+        std::vector<bool> fromSpans(21);
+        area.forEachAvailableSpan(y, [&] (int begin, int end) {
+            for (int x = begin; x < end; ++x) fromSpans[x] = true;
+        });
+        for (int x = 0; x < 21; ++x) {
+            ASSERT_EQ(fromSpans[x], area.isCellAvailable(x, y)) 
+                << x << ' ' << y;
+        }
+    }
+    int calls = 0;
+    area.forEachAvailableSpan(10, 5, 8, [&] (int begin, int end) {
+        ++calls;
+        ASSERT_EQ(begin, 5);
+        ASSERT_EQ(end, 8);
+    });
+    ASSERT_EQ(calls, 1);
+
+    area.lock();
+    area.forEachAvailableSpan(10, [&] (int, int) { ++calls; });
+    ASSERT_EQ(calls, 1);
+
+    // вне поля - out_of_range, вне фигуры - logic_error
+    ASSERT_THROW(field->hasCreatureInCell(21, 10), std::out_of_range);
+    ASSERT_THROW(field->hasCreatureInCell(0, 0), std::logic_error);
+}
+
+// #################################################################################################
+// topology tests
+// #################################################################################################
+TEST(TopologyTest, GhostBorderFollowsTopology) {
+    using topology::topology_t;
+
+    // сетка 3 x 2 с рамкой в 2 клетки
+    constexpr int w = 3, h = 2, b = 2, stride = w + 2 * b;
+    auto makeGrid = [] {
+        std::vector<int> grid(stride * (h + 2 * b), -1);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                grid[(y + b) * stride + x + b] = y * w + x;
+            }
+        }
+        return grid;
+    };
+    auto at = [] (const std::vector<int>& grid, int x, int y) {
+        return grid[(y + b) * stride + x + b];
+    };
+
+    auto torus = makeGrid();
+    topology::fillGhostBorder(torus.data(), w, h, b, topology_t::TORUS, 0);
+    auto cylinder = makeGrid();
+    topology::fillGhostBorder(
+        cylinder.data(), w, h, b, topology_t::CYLINDER, 0);
+    auto bounded = makeGrid();
+    topology::fillGhostBorder(
+        bounded.data(), w, h, b, topology_t::BOUNDED, 0);
+    for (int y = -b; y < h + b; ++y) {
+        for (int x = -b; x < w + b; ++x) {
+            int wx = (x % w + w) % w;
+            int wy = (y % h + h) % h;
+            ASSERT_EQ(at(torus, x, y), wy * w + wx);
+            bool inY = y >= 0 && y < h;
+            bool inX = x >= 0 && x < w;
+            ASSERT_EQ(at(cylinder, x, y), inY ? y * w + wx : 0);
+            ASSERT_EQ(at(bounded, x, y), inY && inX ? y * w + x : 0);
+        }
+    }
+}
+
+TEST(TopologyTest, NeighborTableFollowsTopology) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using topology::topology_t;
+
+    auto neighborsOfCorner = [] (topology_t topology) {
+        GameFieldWithFigure field(
+            6, 5,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>(),
+            topology);
+        EXPECT_EQ(field.topology(), topology);
+        auto table = field.neighborTable();
+        return table->neighbors(table->index(0, 0)).size();
+    };
+    ASSERT_EQ(neighborsOfCorner(topology_t::BOUNDED), 3);
+    ASSERT_EQ(neighborsOfCorner(topology_t::CYLINDER), 5);
+    ASSERT_EQ(neighborsOfCorner(topology_t::TORUS), 8);
+}
+
+TEST(TopologyTest, EnginesMatchCellwiseModelOnWrappedFields) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+    using topology::topology_t;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    for (auto topology : { topology_t::TORUS, topology_t::CYLINDER }) {
+        // ширина 64 - без неполного слова, 70 - с неполным
+        for (int width : { 64, 70 }) {
+            auto makeField = [&] {
+                return std::make_shared<GameFieldWithFigure>(
+                    width, 21,
+                    std::make_unique<CreatureFactory>(),
+                    std::make_unique<FlatCellStorage>(),
+                    std::make_unique<figure::DummyFigure>(),
+                    topology);
+            };
+            std::vector<std::shared_ptr<GameFieldWithFigure>> fields;
+            std::vector<std::unique_ptr<game_model::GameModel>> models;
+            for (int i = 0; i < 4; ++i) {
+                fields.push_back(makeField());
+                fillFieldRandomly(fields.back(), player, 47);
+            }
+            models.push_back(makeModelWithEngine(fields[0], player, nullptr));
+            models.push_back(makeModelWithEngine(fields[1], player, 
+                std::make_unique<BitboardGameEngine>(fields[1])));
+            models.push_back(makeModelWithEngine(fields[2], player, 
+                std::make_unique<ByteGridGameEngine>(fields[2])));
+            models.push_back(makeModelWithEngine(fields[3], player, 
+                std::make_unique<MooreGameEngine>(fields[3])));
+            for (int gen = 0; gen < 12; ++gen) {
+                for (auto&& model : models) {
+                    model->computeEr_();
+                }
+                for (int i = 1; i < 4; ++i) {
+                    ASSERT_TRUE(eqFields(fields[i], fields[0])) 
+                        << static_cast<int>(topology) << ' ' << width 
+                        << ' ' << i << ' ' << gen;
+                }
+            }
+        }
+    }
+}
+
+// #################################################################################################
+// counter rng tests
+// #################################################################################################
+TEST(CounterRngTest, ReproducibleAndUniform) {
+    using counter_rng::CounterRng;
+
+    constexpr CounterRng rng(42);
+    static_assert(rng.stream(3)(5, 7) == CounterRng(42).stream(3)(5, 7));
+    ASSERT_NE(rng.stream(3)(5, 7), rng.stream(4)(5, 7));
+    ASSERT_NE(rng.stream(3)(5, 7), rng.stream(3)(7, 5));
+    ASSERT_NE(rng.stream(3)(5, 7), CounterRng(43).stream(3)(5, 7));
+
+    // значения в [0, bound) и распределены примерно поровну
+    constexpr int bound = 3;
+    std::array<int, bound> hits{};
+    auto gen = rng.stream(0);
+    for (int y = 0; y < 300; ++y) {
+        for (int x = 0; x < 300; ++x) {
+            auto v = gen.uniform(bound, x, y);
+            ASSERT_LT(v, bound);
+            ++hits[v];
+        }
+    }
+    for (auto h : hits) {
+        ASSERT_NEAR(h, 300 * 300 / bound, 300 * 300 / bound / 20);
+    }
+}
+
+TEST(CounterRngTest, TieBreaksMatchAcrossEnginesAndThreads) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+    using namespace creature_strategy;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+        std::make_shared<player::Player>(3, "player3"),  
+    };
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            67, 45,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>(),
+            topology::topology_t::TORUS);
+    };
+    // при B36 у трёх игроков часты ничьи 2-2-2 и 3-3
+    auto strategy = [] { return std::make_unique<HighLifeCreatureStrategy>(); };
+    std::vector<std::shared_ptr<GameFieldWithFigure>> fields;
+    for (int i = 0; i < 5; ++i) {
+        fields.push_back(makeField());
+        fillFieldRandomly(fields.back(), player, 53);
+    }
+    std::vector<std::unique_ptr<game_model::GameModel>> models;
+    models.push_back(makeModelWithEngine(
+        fields[0], player, nullptr, strategy()));
+    models.push_back(makeModelWithEngine(fields[1], player,
+        std::make_unique<BitboardGameEngine>(fields[1]), strategy()));
+    models.push_back(makeModelWithEngine(fields[2], player,
+        std::make_unique<ByteGridGameEngine>(fields[2]), strategy()));
+    models.push_back(makeModelWithEngine(fields[3], player,
+        std::make_unique<MooreGameEngine>(fields[3]), strategy()));
+    {
+        auto area = std::make_unique<GameFieldWithFigureArea>(
+            fields[4], std::pair{ 0, 0 }, std::pair{ 66, 44 });
+        area->unlock();
+        auto f = std::make_unique<GameFieldWithFigureAreaCurryFactory>(
+            fields[4]);
+        models.push_back(std::make_unique<game_model::GameModel>(
+            0, 0, 0, std::move(area), std::move(f), player, strategy(),
+            nullptr, std::make_unique<thread_pool::ThreadPool>(3)));
+    }
+    for (auto&& model : models) {
+        model->setSeed(2024);
+        ASSERT_EQ(model->seed(), 2024);
+    }
+    for (int gen = 0; gen < 12; ++gen) {
+        for (auto&& model : models) {
+            model->computeEr_();
+        }
+        for (int i = 1; i < 5; ++i) {
+            ASSERT_TRUE(eqFields(fields[i], fields[0])) << i << ' ' << gen;
+        }
+    }
+
+    // другое зерно - другой выбор среди равных
+    auto otherField = makeField();
+    fillFieldRandomly(otherField, player, 53);
+    auto otherModel = makeModelWithEngine(
+        otherField, player, nullptr, strategy());
+    otherModel->setSeed(2025);
+    for (int gen = 0; gen < 12; ++gen) {
+        otherModel->computeEr_();
+    }
+    ASSERT_FALSE(eqFields(otherField, fields[0]));
+}
+
+// #################################################################################################
+// object reuse tests
+// #################################################################################################
+namespace {
+    struct CountingCreatureFactory : public factory::ICreatureFactory {
+        std::unique_ptr<creature::ICreature> createCreature(
+            std::shared_ptr<player::Player> player) const override
+        {
+            ++created;
+            return std::make_unique<creature::Creature>(player);
+        }
+        mutable int created = 0;
+    };
+
+    struct CountingCellFactory : public factory::ICellFactory {
+        std::unique_ptr<cell::ICell> createCell() const override {
+            ++created;
+            return std::make_unique<cell::Cell>();
+        }
+        mutable int created = 0;
+    };
+} // namespace
+
+TEST(ObjectReuseTest, SetRemoveCreatesOneCreaturePerPlayer) {
+    using namespace game_field;
+    using namespace factory;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto creatureFactory = std::make_unique<CountingCreatureFactory>();
+    auto* counter = creatureFactory.get();
+    auto field = std::make_shared<GameFieldWithFigure>(
+        20, 20,
+        std::move(creatureFactory),
+        std::make_unique<CellFactory>(),
+        std::make_unique<figure::DummyFigure>());
+    for (int round = 0; round < 3; ++round) {
+        for (int y = 0; y < 20; ++y) {
+            for (int x = 0; x < 20; ++x) {
+                field->setCreatureInCell(x, y, player[(x + y) % 2]);
+            }
+        }
+        for (int y = 0; y < 20; y += 2) {
+            for (int x = 0; x < 20; ++x) {
+                field->removeCreatureInCell(x, y);
+            }
+        }
+        field->clear();
+    }
+    // существа живут в реестре игроков, клетки хранят только владельца
+    ASSERT_EQ(counter->created, 2);
+    field->setCreatureInCell(0, 0, player[1]);
+    ASSERT_EQ(field->getCreatureByCell(0, 0).player(), player[1]);
+}
+
+TEST(ObjectReuseTest, ClearReusesCellObjects) {
+    using namespace game_field;
+    using namespace factory;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+    };
+    auto cellFactory = std::make_unique<CountingCellFactory>();
+    auto* counter = cellFactory.get();
+    auto field = std::make_shared<GameFieldWithFigure>(
+        7, 5,
+        std::make_unique<CreatureFactory>(),
+        std::move(cellFactory),
+        std::make_unique<figure::DummyFigure>());
+    ASSERT_EQ(counter->created, 7 * 5);
+    for (int i = 0; i < 4; ++i) {
+        field->setCreatureInCell(i, i, player[0]);
+        field->clear();
+        for (int y = 0; y < 5; ++y) {
+            for (int x = 0; x < 7; ++x) {
+                ASSERT_FALSE(field->hasCreatureInCell(x, y));
+            }
+        }
+    }
+    ASSERT_EQ(counter->created, 7 * 5);
+}
+
+// #################################################################################################
+// counting storage tests
+// #################################################################################################
+TEST(CountingStorageTest, CountsFollowSetAndRemove) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+        std::make_shared<player::Player>(3, "player3"),  
+    };
+    auto makeFields = [] (auto storage) {
+        std::vector<std::shared_ptr<GameFieldWithFigure>> res;
+        res.push_back(std::make_shared<GameFieldWithFigure>(
+            21, 21,
+            std::make_unique<CreatureFactory>(),
+            storage(),
+            std::make_unique<figure::Romb>(20, 20),
+            topology::topology_t::TORUS));
+        res.push_back(
+            std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+                21, 21,
+                std::make_unique<CreatureFactory>(),
+                storage(),
+                std::make_unique<figure::DummyFigure>(),
+                topology::topology_t::CYLINDER));
+        return res;
+    };
+    auto actual = makeFields([] { return std::make_unique<CountingCellStorage>(); });
+    auto expect = makeFields([] { return std::make_unique<FlatCellStorage>(); });
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> coord(0, 20);
+    std::uniform_int_distribution<int> action(0, 3);
+    for (std::size_t f = 0; f < actual.size(); ++f) {
+        for (int step = 0; step < 2000; ++step) {
+            int x = coord(gen);
+            int y = coord(gen);
+            int a = action(gen);
+            if (actual[f]->isExcludedCell(x, y)) continue;
+            for (auto&& field : {actual[f], expect[f]}) {
+                if (a == 3) {
+                    field->removeCreatureInCell(x, y);
+                } else {
+                    field->setCreatureInCell(x, y, player[a]);
+                }
+            }
+        }
+        neighbor_counts_t actualCount;
+        neighbor_counts_t expectCount;
+        for (int y = 0; y < 21; ++y) {
+            for (int x = 0; x < 21; ++x) {
+                if (actual[f]->isExcludedCell(x, y)) continue;
+                actual[f]->countCellNeighborsCreatures(x, y, actualCount);
+                expect[f]->countCellNeighborsCreatures(x, y, expectCount);
+                ASSERT_EQ(actualCount, expectCount) << f << ' ' << x << ' ' << y;
+            }
+        }
+        actual[f]->clear();
+        actual[f]->countCellNeighborsCreatures(10, 10, actualCount);
+        ASSERT_EQ(actualCount, neighbor_counts_t{});
+    }
+}
+
+TEST(CountingStorageTest, ModelMatchesFlatStorage) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace creature_strategy;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+        std::make_shared<player::Player>(3, "player3"),  
+    };
+    auto actualField = std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+        40, 40,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<CountingCellStorage>(),
+        std::make_unique<figure::DummyFigure>(),
+        topology::topology_t::TORUS);
+    auto expectField = std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+        40, 40,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>(),
+        topology::topology_t::TORUS);
+    fillFieldRandomly(actualField, player, 19);
+    fillFieldRandomly(expectField, player, 19);
+
+    auto actualModel = makeModelWithEngine(actualField, player, nullptr,
+        std::make_unique<HighLifeCreatureStrategy>());
+    auto expectModel = makeModelWithEngine(expectField, player, nullptr,
+        std::make_unique<HighLifeCreatureStrategy>());
+    actualModel->setSeed(5);
+    expectModel->setSeed(5);
+    for (int gen = 0; gen < 20; ++gen) {
+        actualModel->computeEr_();
+        expectModel->computeEr_();
+        ASSERT_TRUE(eqFields(actualField, expectField)) << gen;
+    }
+}
+
+// #################################################################################################
+// population tests
+// #################################################################################################
+namespace {
+    cell_storage::population_t scanPopulation(
+        const game_field::GameFieldWithFigure& field,
+        std::pair<int, int> ul, std::pair<int, int> lr)
+    {
+        cell_storage::population_t res{};
+        for (int y = ul.second; y <= lr.second; ++y) {
+            for (int x = ul.first; x <= lr.first; ++x) {
+                if (!field.isExcludedCell(x, y)) {
+                    ++res[field.storage().owner(x, y)];
+                }
+            }
+        }
+        res[cell_storage::emptyOwner] = 0;
+        return res;
+    }
+} // namespace
+
+TEST(PopulationTest, CountsFollowSetRemoveAndGenerations) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        30, 24,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::Romb>(29, 23),
+        topology::topology_t::TORUS);
+    fillFieldRandomly(field, player, 3);
+    // зона создаётся после заполнения: начальное количество считается обходом
+    std::pair<int, int> ul { 5, 3 };
+    std::pair<int, int> lr { 17, 20 };
+    GameFieldWithFigureArea area(field, ul, lr);
+    area.unlock();
+    auto checkCounts = [&] {
+        ASSERT_EQ(field->population(), 
+                  scanPopulation(*field, {0, 0}, {29, 23}));
+        ASSERT_EQ(area.population(), scanPopulation(*field, ul, lr));
+    };
+    checkCounts();
+
+    auto cellwise = makeModelWithEngine(field, player, nullptr);
+    auto bitboard = makeModelWithEngine(field, player, 
+        std::make_unique<BitboardGameEngine>(field));
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> xs(0, 29);
+    std::uniform_int_distribution<int> ys(0, 23);
+    for (int step = 0; step < 10; ++step) {
+        for (int i = 0; i < 30; ++i) {
+            int x = xs(gen);
+            int y = ys(gen);
+            if (field->isExcludedCell(x, y)) continue;
+            if (i % 3) {
+                field->setCreatureInCell(x, y, player[i % 2]);
+            } else {
+                field->removeCreatureInCell(x, y);
+            }
+        }
+        checkCounts();
+        (step % 2 ? cellwise : bitboard)->computeEr_();
+        checkCounts();
+    }
+    field->clear();
+    ASSERT_EQ(field->population(), population_t{});
+    ASSERT_EQ(area.population(), population_t{});
+}
+
+TEST(PopulationTest, EmptyOwnerIsNeverCounted) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+
+    auto player1 = std::make_shared<player::Player>(1, "player1");
+    auto player2 = std::make_shared<player::Player>(2, "player2");
+    auto field = std::make_shared<GameFieldWithFigure>(
+        6, 4,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    GameFieldWithFigureArea area(
+        field, std::make_pair(0, 0), std::make_pair(2, 3));
+    area.unlock();
+    auto own1 = field->registerPlayer(player1);
+    auto own2 = field->registerPlayer(player2);
+    auto expectCounts = [&] (int fieldFirst, int fieldSecond,
+                             int areaFirst, int areaSecond) {
+        for (auto&& pop : { field->population(), area.population() }) {
+            ASSERT_EQ(pop[emptyOwner], 0);
+        }
+        ASSERT_EQ(field->population()[own1], fieldFirst);
+        ASSERT_EQ(field->population()[own2], fieldSecond);
+        ASSERT_EQ(area.population()[own1], areaFirst);
+        ASSERT_EQ(area.population()[own2], areaSecond);
+    };
+
+    field->setCreatureInCell(0, 0, player1);
+    field->setCreatureInCell(4, 0, player1);
+    expectCounts(2, 0, 1, 0);
+    // клетка переходит от игрока к игроку, минуя пустое состояние
+    std::vector<change_t> batch { 
+        { 0, 0, own2 }, { 1, 1, own1 }, { 4, 0, emptyOwner }, 
+        { 5, 3, emptyOwner }
+    };
+    field->applyChanges(batch);
+    expectCounts(1, 1, 1, 1);
+    field->beginGeneration();
+    field->setNextOwner(1, 1, emptyOwner);
+    field->setNextOwner(3, 2, own2);
+    field->swapGeneration();
+    expectCounts(0, 2, 0, 1);
+    field->removeCreatureInCell(0, 0);
+    field->removeCreatureInCell(0, 0);
+    expectCounts(0, 1, 0, 0);
+    field->clear();
+    expectCounts(0, 0, 0, 0);
+}
+
+TEST(PopulationTest, AreasShareRegionsAndDetectWinner) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using player::PlayerRegistry;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        10, 10,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    int region;
+    {
+        auto a = std::make_unique<GameFieldWithFigureArea>(
+            field, std::pair{ 0, 0 }, std::pair{ 4, 9 });
+        GameFieldWithFigureArea b(field, { 0, 0 }, { 4, 9 });
+        region = field->trackRegion({ 0, 0 }, { 4, 9 });
+        field->untrackRegion(region);
+        a.reset();
+        field->setCreatureInCell(1, 1, player[1]);
+        field->setCreatureInCell(7, 1, player[0]);
+        // в закрытой зоне нет доступных клеток
+        ASSERT_EQ(b.population(), population_t{});
+        ASSERT_TRUE(b.checkCreatureInArea().empty());
+        b.unlock();
+        ASSERT_EQ(b.population()[PlayerRegistry::ownerOf(*player[1])], 1);
+        ASSERT_EQ(b.population()[PlayerRegistry::ownerOf(*player[0])], 0);
+        ASSERT_EQ(b.checkCreatureInArea(), 
+                  std::set<std::shared_ptr<player::Player>>{ player[1] });
+    }
+    ASSERT_THROW(field->regionPopulation(region), std::out_of_range);
+    ASSERT_THROW(field->untrackRegion(region), std::out_of_range);
+
+    // блок 2x2 первого игрока устойчив, одиночные клетки второго умирают
+    field->clear();
+    field->setCreatureInCell(2, 2, player[0]);
+    field->setCreatureInCell(3, 2, player[0]);
+    field->setCreatureInCell(2, 3, player[0]);
+    field->setCreatureInCell(3, 3, player[0]);
+    field->setCreatureInCell(8, 8, player[1]);
+    auto model = makeModelWithEngine(field, player, nullptr);
+    auto [suc, win, winner] = model->computeEr_();
+    ASSERT_FALSE(suc);
+    ASSERT_TRUE(win);
+    ASSERT_EQ(winner, player[0]);
+    ASSERT_EQ(field->population()[PlayerRegistry::ownerOf(*player[0])], 4);
+    ASSERT_EQ(field->population()[PlayerRegistry::ownerOf(*player[1])], 0);
+
+    // закрытая зона модели: существ в ней нет, как и раньше - ничья
+    field->setCreatureInCell(8, 8, player[1]);
+    auto lockedArea = std::make_unique<GameFieldWithFigureArea>(
+        field, std::pair{ 0, 0 }, std::pair{ 9, 9 });
+    game_model::GameModel lockedModel(
+        0, 0, 0, std::move(lockedArea), 
+        std::make_unique<factory::GameFieldWithFigureAreaCurryFactory>(field),
+        player, std::make_unique<creature_strategy::ConwayCreatureStrategy>());
+    auto [lockedSuc, lockedWin, lockedWinner] = lockedModel.computeEr_();
+    ASSERT_FALSE(lockedSuc);
+    ASSERT_FALSE(lockedWin);
+    ASSERT_EQ(lockedWinner, nullptr);
+}
+
+// #################################################################################################
+// batch changes tests
+// #################################################################################################
+namespace {
+    enum class field_evt_t { CREATURE_SET, CREATURE_REMOVED, CHANGES_APPLIED, FIELD_CLEARED };
+
+    struct EventCounter {
+        void on(const game_event::CreatureSet& evt) {
+            evt_.push_back(field_evt_t::CREATURE_SET);
+            changes_ = evt.changes;
+        }
+
+        void on(const game_event::CreatureRemoved& evt) {
+            evt_.push_back(field_evt_t::CREATURE_REMOVED);
+            changes_ = evt.changes;
+        }
+
+        void on(const game_event::ChangesApplied& evt) {
+            evt_.push_back(field_evt_t::CHANGES_APPLIED);
+            changes_ = evt.changes;
+        }
+
+        void on(const game_event::FieldCleared&) {
+            evt_.push_back(field_evt_t::FIELD_CLEARED);
+        }
+
+        std::vector<cell_storage::change_t> changes() const {
+            std::vector<cell_storage::change_t> res;
+            changes_->forEach([&] (int x, int y, cell_storage::owner_t own) {
+                res.emplace_back(x, y, own);
+            });
+            return res;
+        }
+
+        std::vector<field_evt_t> evt_;
+        std::shared_ptr<const change_set::ChangeSet> changes_;
+    };
+} // namespace
+
+TEST(BatchChangesTest, BatchFiresOneEvent) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_engine;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        40, 30,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    auto obs = std::make_shared<EventCounter>();
+    field->events().subscribe(obs);
+
+    auto own1 = field->registerPlayer(player[0]);
+    auto own2 = field->registerPlayer(player[1]);
+    field->setCreatureInCell(5, 5, player[0]);
+    obs->evt_.clear();
+    std::vector<change_t> batch {
+        { 1, 1, own1 }, { 2, 1, own2 }, { 3, 1, own1 },
+        // тот же владелец - клетка не меняется
+        { 5, 5, own1 }, 
+        { 6, 6, emptyOwner },
+    };
+    field->applyChanges(batch);
+    std::vector<field_evt_t> expectEvents { field_evt_t::CHANGES_APPLIED };
+    ASSERT_EQ(obs->evt_, expectEvents);
+    std::vector<change_t> expectChanges {
+        { 1, 1, own1 }, { 2, 1, own2 }, { 3, 1, own1 },
+    };
+    ASSERT_EQ(obs->changes(), expectChanges);
+    ASSERT_EQ(field->population()[own1], 3);
+    ASSERT_EQ(field->population()[own2], 1);
+    ASSERT_EQ(field->getCreatureByCell(2, 1).player(), player[1]);
+
+    // поколение движка применяется одним пакетом
+    fillFieldRandomly(field, player, 23);
+    auto before = dynamic_cast<const FlatCellStorage&>(
+        field->storage()).owners();
+    obs->evt_.clear();
+    auto model = makeModelWithEngine(field, player, 
+        std::make_unique<BitboardGameEngine>(field));
+    model->computeEr_();
+    ASSERT_EQ(obs->evt_, expectEvents);
+    int changed = 0;
+    for (int y = 0; y < 30; ++y) {
+        for (int x = 0; x < 40; ++x) {
+            changed += field->storage().owner(x, y) != before[y * 40 + x];
+        }
+    }
+    ASSERT_GT(changed, 0);
+    ASSERT_EQ(static_cast<int>(obs->changes_->size()), changed);
+
+    // часть поля очищается одним пакетом
+    GameFieldWithFigureArea area(field, { 0, 0 }, { 19, 29 });
+    area.unlock();
+    obs->evt_.clear();
+    area.clear();
+    ASSERT_EQ(obs->evt_, expectEvents);
+    ASSERT_EQ(area.population(), population_t{});
+}
+
+TEST(BatchChangesTest, InvalidBatchIsRejectedWhole) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+
+    auto player1 = std::make_shared<player::Player>(1, "player1");
+    auto field = std::make_shared<GameFieldWithFigure>(
+        10, 10,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::Romb>(5, 5));
+    auto obs = std::make_shared<EventCounter>();
+    field->events().subscribe(obs);
+    auto own = field->registerPlayer(player1);
+
+    std::vector<change_t> excluded { { 4, 4, own }, { 0, 0, own } };
+    ASSERT_THROW(field->applyChanges(excluded), std::logic_error);
+    std::vector<change_t> outside { { 4, 4, own }, { 10, 4, own } };
+    ASSERT_THROW(field->applyChanges(outside), std::out_of_range);
+    std::vector<change_t> unknownOwner { { 4, 4, own }, { 5, 4, own + 1 } };
+    ASSERT_THROW(field->applyChanges(unknownOwner), std::logic_error);
+    ASSERT_FALSE(field->hasCreatureInCell(4, 4));
+    ASSERT_TRUE(obs->evt_.empty());
+
+    GameFieldWithFigureArea area(field, { 0, 0 }, { 4, 9 });
+    area.unlock();
+    std::vector<change_t> outsideArea { { 4, 4, own }, { 5, 4, own } };
+    ASSERT_THROW(area.applyChanges(outsideArea), std::logic_error);
+    ASSERT_FALSE(field->hasCreatureInCell(4, 4));
+    area.applyChanges(std::span(outsideArea).first(1));
+    ASSERT_TRUE(field->hasCreatureInCell(4, 4));
+    ASSERT_EQ(obs->evt_.size(), 1u);
+}
+
+// #################################################################################################
+// change set tests
+// #################################################################################################
+TEST(ChangeSetTest, KeptSetsStayIntactAndReplayLater) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    // наборы сохраняются и разбираются после расчёта поколений
+    struct Recorder {
+        void on(const game_event::CreatureSet& evt)
+        { sets_.push_back(evt.changes); }
+
+        void on(const game_event::CreatureRemoved& evt)
+        { sets_.push_back(evt.changes); }
+
+        void on(const game_event::ChangesApplied& evt)
+        { sets_.push_back(evt.changes); }
+
+        std::vector<std::shared_ptr<const change_set::ChangeSet>> sets_;
+    };
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        30, 20,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>(),
+        topology::topology_t::TORUS);
+    auto obs = std::make_shared<Recorder>();
+    field->events().subscribe(obs);
+    fillFieldRandomly(field, player, 31);
+    auto model = makeModelWithEngine(field, player, nullptr);
+    for (int gen = 0; gen < 8; ++gen) {
+        model->computeEr_();
+    }
+
+    std::vector<owner_t> mirror(30 * 20, emptyOwner);
+    for (std::size_t i = 0; i < obs->sets_.size(); ++i) {
+        ASSERT_EQ(obs->sets_[i]->sequence(), obs->sets_[0]->sequence() + i);
+        for (std::size_t j = 0; j < obs->sets_[i]->size(); ++j) {
+            mirror[obs->sets_[i]->cell(j)] = obs->sets_[i]->owner(j);
+        }
+    }
+    ASSERT_EQ(mirror, dynamic_cast<const FlatCellStorage&>(
+        field->storage()).owners());
+}
+
+TEST(ChangeSetTest, UnkeptSetIsReused) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    struct Peeker {
+        void on(const game_event::CreatureSet& evt) { 
+            seen_.push_back(evt.changes.get());
+            sequence_.push_back(evt.changes->sequence());
+            if (keep_) kept_ = evt.changes;
+        }
+
+        bool keep_ = false;
+        std::vector<const change_set::ChangeSet*> seen_;
+        std::vector<std::uint64_t> sequence_;
+        std::shared_ptr<const change_set::ChangeSet> kept_;
+    };
+
+    auto player1 = std::make_shared<player::Player>(1, "player1");
+    auto field = std::make_shared<GameFieldWithFigure>(
+        5, 5,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    auto obs = std::make_shared<Peeker>();
+    field->events().subscribe(obs);
+
+    field->setCreatureInCell(0, 0, player1);
+    field->setCreatureInCell(1, 0, player1);
+    // набор никто не сохранил - память переиспользуется
+    ASSERT_EQ(obs->seen_[0], obs->seen_[1]);
+    obs->keep_ = true;
+    field->setCreatureInCell(2, 0, player1);
+    field->setCreatureInCell(3, 0, player1);
+    ASSERT_NE(obs->seen_[2], obs->seen_[3]);
+    ASSERT_EQ(obs->kept_->position(0), std::make_pair(3, 0));
+    std::vector<std::uint64_t> expectSequence { 0, 1, 2, 3 };
+    ASSERT_EQ(obs->sequence_, expectSequence);
+}
+
+TEST(ChangeSetTest, SetReleasedOnAnotherThreadReturnsToPool) {
+    change_set::ChangeSetPool pool;
+    auto set = pool.acquire(5, 0);
+    set->add(1, 2, 1);
+    const change_set::ChangeSet* first = set.get();
+
+    // последний владелец освобождает набор в другом потоке
+    std::thread consumer([kept = std::shared_ptr<const change_set::ChangeSet>(
+        std::move(set))] () mutable {
+        ASSERT_EQ(kept->position(0), std::make_pair(1, 2));
+        kept.reset();
+    });
+    consumer.join();
+
+    auto again = pool.acquire(7, 1);
+    ASSERT_EQ(again.get(), first);
+    ASSERT_TRUE(again->empty());
+    ASSERT_EQ(again->width(), 7);
+    ASSERT_EQ(again->sequence(), 1);
+    // набор, выданный и ещё не освобождённый, не выдаётся повторно
+    ASSERT_NE(pool.acquire(7, 2).get(), first);
+}
+
+// #################################################################################################
+// event bus tests
+// #################################################################################################
+namespace {
+    struct Ping { int value; };
+    struct Pong {};
+
+    using TestBus = event_bus::EventBus<Ping, Pong>;
+
+    struct PingCounter {
+        void on(const Ping& evt) { 
+            ++calls_;
+            sum_ += evt.value;
+            if (onPing_) onPing_();
+        }
+
+        int calls_ = 0;
+        int sum_ = 0;
+        std::function<void()> onPing_;
+    };
+
+    struct PingPongCounter : PingCounter {
+        using PingCounter::on;
+        void on(const Pong&) { ++pongs_; }
+
+        int pongs_ = 0;
+    };
+} // namespace
+
+TEST(EventBusTest, DispatchSkipsExpiredAndFollowsUnsubscribe) {
+    static_assert(event_bus::handles<PingCounter, Ping>);
+    static_assert(!event_bus::handles<PingCounter, Pong>);
+
+    TestBus bus;
+    auto a = std::make_shared<PingCounter>();
+    auto b = std::make_shared<PingPongCounter>();
+    bus.subscribe(a);
+    // обработчик попадает только в списки событий, которые он принимает
+    ASSERT_FALSE(bus.hasSubscribers<Pong>());
+    bus.subscribe(b);
+    ASSERT_TRUE(bus.hasSubscribers<Pong>());
+
+    bus.publish(Ping{ 3 });
+    ASSERT_EQ(a->calls_, 1);
+    ASSERT_EQ(a->sum_, 3);
+    ASSERT_EQ(b->calls_, 1);
+    // умерший обработчик пропускается
+    std::weak_ptr<PingCounter> weakA = a;
+    a.reset();
+    ASSERT_TRUE(weakA.expired());
+    bus.publish(Ping{ 4 });
+    ASSERT_EQ(b->sum_, 7);
+
+    bus.publish(Pong{});
+    ASSERT_EQ(b->pongs_, 1);
+    bus.unsubscribe(b);
+    bus.publish(Ping{ 5 });
+    bus.publish(Pong{});
+    ASSERT_EQ(b->calls_, 2);
+    ASSERT_EQ(b->pongs_, 1);
+    ASSERT_FALSE(bus.hasSubscribers<Ping>());
+}
+
+TEST(EventBusTest, HandlerCanSubscribeDuringDispatch) {
+    TestBus bus;
+    std::vector<std::shared_ptr<PingCounter>> added;
+    auto first = std::make_shared<PingCounter>();
+    // подписка на то же событие перевыделяет список во время обхода
+    first->onPing_ = [&] {
+        for (int i = 0; i < 8; ++i) {
+            added.push_back(std::make_shared<PingCounter>());
+            bus.subscribe(added.back());
+        }
+    };
+    bus.subscribe(first);
+    bus.publish(Ping{ 1 });
+    first->onPing_ = nullptr;
+    ASSERT_EQ(first->calls_, 1);
+    ASSERT_EQ(added.size(), 8u);
+    // новые обработчики получили уже идущее событие
+    for (auto&& h : added) {
+        ASSERT_EQ(h->calls_, 1);
+    }
+    bus.publish(Ping{ 1 });
+    ASSERT_EQ(first->calls_, 2);
+    for (auto&& h : added) {
+        ASSERT_EQ(h->calls_, 2);
+    }
+}
+
+TEST(EventBusTest, HandlerCanUnsubscribeDuringDispatch) {
+    TestBus bus;
+    auto first = std::make_shared<PingCounter>();
+    auto expired = std::make_shared<PingCounter>();
+    auto second = std::make_shared<PingCounter>();
+    auto third = std::make_shared<PingCounter>();
+    auto added = std::make_shared<PingCounter>();
+    bus.subscribe(first);
+    bus.subscribe(expired);
+    bus.subscribe(second);
+    bus.subscribe(third);
+    expired.reset();
+    // отписка и подписка внутри on() не сдвигают ещё не оповещённых
+    first->onPing_ = [&] {
+        bus.unsubscribe(first);
+        bus.subscribe(added);
+    };
+    second->onPing_ = [&] { bus.unsubscribe(second); };
+    bus.publish(Ping{ 1 });
+    ASSERT_EQ(first->calls_, 1);
+    ASSERT_EQ(second->calls_, 1);
+    ASSERT_EQ(third->calls_, 1);
+    ASSERT_EQ(added->calls_, 1);
+
+    bus.publish(Ping{ 1 });
+    ASSERT_EQ(first->calls_, 1);
+    ASSERT_EQ(second->calls_, 1);
+    ASSERT_EQ(third->calls_, 2);
+    ASSERT_EQ(added->calls_, 2);
+
+    // обработчики есть, пока жив хотя бы один
+    third.reset();
+    ASSERT_TRUE(bus.hasSubscribers<Ping>());
+    added.reset();
+    ASSERT_FALSE(bus.hasSubscribers<Ping>());
+}
+
+TEST(EventBusTest, FieldSkipsChangeSetsWithoutSubscribers) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+
+    struct SetOnly {
+        void on(const game_event::CreatureSet& evt) 
+        { sequence_.push_back(evt.changes->sequence()); }
+
+        std::vector<std::uint64_t> sequence_;
+    };
+
+    auto player1 = std::make_shared<player::Player>(1, "player1");
+    auto field = std::make_shared<GameFieldWithFigure>(
+        5, 5,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    auto own = field->registerPlayer(player1);
+    auto obs = std::make_shared<SetOnly>();
+    field->events().subscribe(obs);
+
+    // у пакета и поколения нет обработчиков - наборы не собираются
+    std::vector<change_t> batch { { 0, 0, own }, { 1, 0, own } };
+    field->applyChanges(batch);
+    field->beginGeneration();
+    field->swapGeneration();
+    field->setCreatureInCell(2, 0, player1);
+    std::vector<std::uint64_t> expectSequence { 0 };
+    ASSERT_EQ(obs->sequence_, expectSequence);
+    ASSERT_EQ(field->population()[own], 3);
+}
+
+// #################################################################################################
+// simulation thread tests
+// #################################################################################################
+TEST(SimulationThreadTest, QueueDeliversEveryEventInOrder) {
+    TestBus bus;
+    auto queue = std::make_shared<event_bus::EventQueue<Ping>>();
+    // очередь принимает только Ping
+    bus.subscribe(queue);
+    ASSERT_FALSE(bus.hasSubscribers<Pong>());
+
+    constexpr int n = 2000;
+    std::thread producer([&bus] {
+        for (int i = 1; i <= n; ++i) {
+            bus.publish(Ping{ i });
+        }
+    });
+    struct OrderChecker {
+        void on(const Ping& evt) {
+            ordered_ = ordered_ && evt.value == last_ + 1;
+            last_ = evt.value;
+        }
+
+        int last_ = 0;
+        bool ordered_ = true;
+    } checker;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (checker.last_ < n && std::chrono::steady_clock::now() < deadline) {
+        queue->waitAndDispatch(checker, std::chrono::milliseconds(10));
+    }
+    producer.join();
+    ASSERT_TRUE(checker.ordered_);
+    ASSERT_EQ(checker.last_, n);
+    ASSERT_EQ(queue->dispatch(checker), 0u);
+}
+
+TEST(SimulationThreadTest, SnapshotsListOnlyCellsChangedSinceTaken) {
+    using namespace game_field;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace field_snapshot;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        24, 16,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>(),
+        topology::topology_t::TORUS);
+    fillFieldRandomly(field, player, 41);
+    auto snapshots = std::make_shared<SnapshotPublisher>(*field);
+    field->events().subscribe(snapshots);
+    auto&& storage = dynamic_cast<const FlatCellStorage&>(field->storage());
+    // читатель собирает поле из снимков
+    std::vector<owner_t> painted(24 * 16, 0xff);
+    auto paint = [&painted] (const FieldSnapshot& snapshot) {
+        for (auto [cell, owner] : snapshot.changedCells()) {
+            painted[cell] = owner;
+        }
+    };
+    auto first = snapshots->take();
+    ASSERT_EQ(first->changedCells().size(), 24u * 16);
+    paint(*first);
+    ASSERT_EQ(painted, storage.owners());
+    // поле не менялось - снимок не собирается
+    ASSERT_EQ(snapshots->take(), nullptr);
+
+    auto model = makeModelWithEngine(field, player, nullptr);
+    auto before = storage.owners();
+    model->computeEr_();
+    auto step = snapshots->take();
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < before.size(); ++i) {
+        changed += before[i] != storage.owners()[i];
+    }
+    ASSERT_EQ(step->changedCells().size(), changed);
+    ASSERT_GT(step->sequence(), first->sequence());
+    paint(*step);
+    ASSERT_EQ(painted, storage.owners());
+
+    // пока снимок не забран, клетки копятся без повторов
+    auto kept = step->changedCells();
+    for (int gen = 0; gen < 6; ++gen) {
+        model->computeEr_();
+    }
+    auto late = snapshots->take();
+    // забранный снимок не меняется
+    ASSERT_EQ(step->changedCells().size(), kept.size());
+    std::set<std::uint32_t> lateCells;
+    for (auto [cell, owner] : late->changedCells()) {
+        lateCells.insert(cell);
+    }
+    ASSERT_EQ(lateCells.size(), late->changedCells().size());
+    paint(*late);
+    ASSERT_EQ(painted, storage.owners());
+
+    field->clear();
+    paint(*snapshots->take());
+    ASSERT_EQ(painted, std::vector<owner_t>(24 * 16, emptyOwner));
+}
+
+TEST(SimulationThreadTest, ModelThreadAppliesQueuedInput) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace game_model;
+    using namespace cell_storage;
+    using namespace field_snapshot;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto field = std::make_shared<GameFieldWithFigure>(
+        8, 4,
+        std::make_unique<CreatureFactory>(),
+        std::make_unique<FlatCellStorage>(),
+        std::make_unique<figure::DummyFigure>());
+    auto area = std::make_unique<GameFieldWithFigureArea>(
+        field, std::make_pair(0, 0), std::make_pair(7, 3));
+    area->unlock();
+    auto model = std::make_shared<GameModel>(
+        1, 1, 1, std::move(area), 
+        std::make_unique<GameFieldWithFigureAreaCurryFactory>(field),
+        player, std::make_unique<creature_strategy::ConwayCreatureStrategy>());
+    auto snapshots = std::make_shared<SnapshotPublisher>(*field);
+    std::vector<cell_storage::owner_t> painted(8 * 4, 0xff);
+    auto paint = [&painted, &snapshots] {
+        if (auto snapshot = snapshots->take()) {
+            for (auto [cell, owner] : snapshot->changedCells()) {
+                painted[cell] = owner;
+            }
+        }
+    };
+    auto modelEvents = std::make_shared<game_event::ModelQueue>();
+    field->events().subscribe(snapshots);
+    field->events().subscribe(model);
+    model->events().subscribe(modelEvents);
+
+    struct Recorder {
+        void on(const game_event::PlayerBetsCreatures& evt) 
+        { bets_.push_back(evt.player); }
+        void on(const game_event::ErCalculated&) {}
+        void on(const game_event::WinnerDetermined&) {}
+        void on(const game_event::DrawDetermined&) { draw_ = true; }
+
+        std::vector<std::shared_ptr<player::Player>> bets_;
+        bool draw_ = false;
+    } rec;
+    // разбирать события модели, пока не выполнится условие
+    auto waitFor = [&] (auto&& done) {
+        auto deadline = 
+            std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            modelEvents->waitAndDispatch(rec, std::chrono::milliseconds(10));
+        }
+        return done();
+    };
+
+    std::thread simulation([&model] { model->game(); });
+    auto inbox = model->inbox();
+    bool firstTurn = waitFor([&] { return rec.bets_.size() == 1; });
+    inbox->on(game_event::UserAskedSetCreature{ 0, 0 });
+    bool secondTurn = waitFor([&] { return rec.bets_.size() == 2; });
+    paint();
+    auto placed = painted[0];
+    inbox->on(game_event::UserAskedSetCreature{ 7, 3 });
+    // одиночные существа умирают - ничья
+    bool draw = waitFor([&] { return rec.draw_; });
+    inbox->on(game_event::UserAskedClose{});
+    simulation.join();
+
+    ASSERT_TRUE(firstTurn);
+    ASSERT_TRUE(secondTurn);
+    ASSERT_TRUE(draw);
+    ASSERT_EQ(rec.bets_[0], player[0]);
+    ASSERT_EQ(rec.bets_[1], player[1]);
+    paint();
+    ASSERT_EQ(placed, player::PlayerRegistry::ownerOf(*player[0]));
+    ASSERT_EQ(painted, 
+              std::vector<cell_storage::owner_t>(8 * 4, cell_storage::emptyOwner));
+}
+
+// #################################################################################################
+// thread pool tests
+// #################################################################################################
+TEST(ThreadPoolTest, RunsEveryTaskOnce) {
+    thread_pool::ThreadPool pool(4);
+    ASSERT_EQ(pool.threadCount(), 4);
+
+    for (int round = 0; round < 20; ++round) {
+        std::vector<std::atomic<int>> runs(100);
+        pool.parallelFor(runs.size(), [&runs] (int i, int) { ++runs[i]; });
+        for (auto&& r : runs) {
+            ASSERT_EQ(r.load(), 1);
+        }
+    }
+    ASSERT_THROW(
+        pool.parallelFor(10, [] (int i, int) { 
+            if (i == 7) throw std::runtime_error("task"); 
+        }), 
+        std::runtime_error);
+    ASSERT_THROW(thread_pool::ThreadPool(0), std::invalid_argument);
+    ASSERT_EQ(pool.stats().tasks, 20 * 100 + 10);
+}
+
+TEST(ThreadPoolTest, IdleWorkerStealsTasks) {
+    thread_pool::ThreadPool pool(2);
+    // задачи 0, 1 в очереди потока 0, задачи 2, 3 - в очереди потока 1;
+    // задача 1 ждёт остальные: их может закончить только второй поток,
+    // значит хотя бы одна задача очереди 0 будет украдена
+    std::atomic<int> done = 0;
+    pool.parallelFor(4, [&] (int i, int) {
+        if (i == 1) {
+            auto deadline = std::chrono::steady_clock::now() 
+                            + std::chrono::seconds(5);
+            while (done != 3 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+        ++done;
+    });
+    ASSERT_EQ(done.load(), 4);
+
+    auto stats = pool.stats();
+    ASSERT_EQ(stats.tasks, 4);
+    ASSERT_GE(stats.steals, 1);
+    ASSERT_EQ(pool.workerStats().size(), 2);
+    pool.resetStats();
+    ASSERT_EQ(pool.stats().tasks, 0);
+    ASSERT_EQ(pool.stats().steals, 0);
+}
+
+TEST(ThreadPoolTest, ParallelStepMatchesSerialStep) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_model;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto makeField = [] {
+        return std::make_shared<GamefieldWithFigureAndTriangularNeighbors>(
+            53, 47,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::DummyFigure>());
+    };
+    auto makeParallelModel = [&player] (
+        std::shared_ptr<GameFieldWithFigure> field, int threads) 
+    {
+        std::pair<int, int> lu {0, 0};
+        std::pair<int, int> rl {field->width() - 1, field->height() - 1};
+        auto area = std::make_unique<GameFieldWithFigureArea>(field, lu, rl);
+        area->unlock();
+        auto f = std::make_unique<GameFieldWithFigureAreaCurryFactory>(field);
+        return std::make_unique<GameModel>(
+            0, 0, 0, std::move(area), std::move(f), player, 
+            std::make_unique<creature_strategy::ConwayCreatureStrategy>(),
+            nullptr,
+            std::make_unique<thread_pool::ThreadPool>(threads));
+    };
+
+    auto serialField = makeField();
+    fillFieldRandomly(serialField, player, 23);
+    auto serialModel = makeModelWithEngine(serialField, player, nullptr);
+    std::vector<std::shared_ptr<GameFieldWithFigure>> fields;
+    std::vector<std::unique_ptr<GameModel>> models;
+    for (int threads : { 1, 3, 8 }) {
+        fields.push_back(makeField());
+        fillFieldRandomly(fields.back(), player, 23);
+        models.push_back(makeParallelModel(fields.back(), threads));
+    }
+    for (int i = 0; i < 15; ++i) {
+        serialModel->computeEr_();
+        for (std::size_t m = 0; m < models.size(); ++m) {
+            models[m]->computeEr_();
+            ASSERT_TRUE(eqFields(fields[m], serialField));
+        }
+    }
+}
+
+TEST(ThreadPoolTest, TileTasksOnFigureMatchSerialStep) {
+    using namespace game_field;
+    using namespace game_field_area;
+    using namespace factory;
+    using namespace cell_storage;
+    using namespace game_model;
+
+    std::vector<std::shared_ptr<player::Player>> player { 
+        std::make_shared<player::Player>(1, "player1"), 
+        std::make_shared<player::Player>(2, "player2"),  
+    };
+    auto makeField = [] {
+        return std::make_shared<GameFieldWithFigure>(
+            71, 71,
+            std::make_unique<CreatureFactory>(),
+            std::make_unique<FlatCellStorage>(),
+            std::make_unique<figure::Romb>(35, 35));
+    };
+    auto serialField = makeField();
+    auto parallelField = makeField();
+    fillFieldRandomly(serialField, player, 31);
+    fillFieldRandomly(parallelField, player, 31);
+
+    // зона - нижняя правая часть поля, не кратная размеру плитки
+    auto makeModel = [&player] (std::shared_ptr<GameFieldWithFigure> field,
+        std::unique_ptr<thread_pool::ThreadPool> pool) 
+    {
+        auto area = std::make_unique<GameFieldWithFigureArea>(
+            field, std::pair{ 5, 9 }, std::pair{ 70, 66 });
+        area->unlock();
+        auto f = std::make_unique<GameFieldWithFigureAreaCurryFactory>(field);
+        return std::make_unique<GameModel>(
+            0, 0, 0, std::move(area), std::move(f), player, 
+            std::make_unique<creature_strategy::ConwayCreatureStrategy>(),
+            nullptr, std::move(pool));
+    };
+    auto serialModel = makeModel(serialField, nullptr);
+    auto parallelModel = makeModel(
+        parallelField, std::make_unique<thread_pool::ThreadPool>(4));
+    ASSERT_EQ(serialModel->threadPool(), nullptr);
+    for (int i = 0; i < 15; ++i) {
+        serialModel->computeEr_();
+        parallelModel->computeEr_();
+        ASSERT_TRUE(eqFieldsInFigure(parallelField, serialField));
+    }
+    ASSERT_GT(parallelModel->threadPool()->stats().tasks, 0);
+}
+
 int main(int argc, char* argv[]) {
     try {
         ::testing::InitGoogleTest(&argc, argv);